@@ -0,0 +1,364 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "arg_parser.hpp"
+
+// Every allocation made by the process goes through these, so each benchmark
+// can report allocations per operation next to its time.
+static size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    ++g_allocations;
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+// Makes the value observable so the compiler cannot drop the work that produced it.
+const void* volatile g_sink = nullptr;
+
+template<typename T>
+void keep(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    g_sink = &value;
+#endif
+}
+
+// Stream buffer that counts and drops everything written to it.
+struct DiscardBuffer : std::streambuf {
+    size_t written = 0;
+
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        written += static_cast<size_t>(count);
+        return count;
+    }
+
+    int overflow(int ch) override {
+        ++written;
+        return ch;
+    }
+};
+
+struct Measurement {
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+// Doubles the iteration count until one batch runs for at least min_time.
+template<typename Fn>
+Measurement measure(Fn&& fn, std::chrono::milliseconds min_time) {
+    using clock = std::chrono::steady_clock;
+    for (size_t iterations = 1;; iterations *= 2) {
+        const size_t allocs_before = g_allocations;
+        const auto start = clock::now();
+        for (size_t i = 0; i < iterations; ++i) fn();
+        const auto elapsed = clock::now() - start;
+        const size_t allocs = g_allocations - allocs_before;
+
+        if (elapsed >= min_time || iterations >= (size_t(1) << 30)) {
+            const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+            return { ns / iterations, static_cast<double>(allocs) / iterations };
+        }
+    }
+}
+
+// A schema of `count` arguments mixing every type, with aliases, choices and env fallbacks.
+void build_schema(argparse::ArgumentParser& parser, size_t count) {
+    parser.auto_help(false);
+    for (size_t i = 0; i < count; ++i) {
+        auto& arg = parser.add_argument("option-" + std::to_string(i))
+            .help("Generated option number " + std::to_string(i));
+        switch (i % 4) {
+            case 0: arg.type_int().min_value(0).max_value(1000000); break;
+            case 1: arg.type_string().default_value("none"); break;
+            case 2: arg.flag(); break;
+            case 3: arg.type_float(); break;
+        }
+        if (i % 5 == 0) arg.add_alias("o" + std::to_string(i));
+        if (i % 8 == 1) arg.choices({ "none", "fast", "small", "balanced" });
+        if (i % 16 == 3) arg.env("ARGPARSE_BENCH_UNSET_" + std::to_string(i));
+    }
+}
+
+// Command line that sets about half of the schema, using aliases where they exist.
+std::vector<std::string> build_argv(size_t count) {
+    std::vector<std::string> argv{ "bench" };
+    for (size_t i = 0; i < count; i += 2) {
+        const size_t index = i + (i / 2) % 2;
+        if (index >= count) break;
+        argv.push_back(index % 5 == 0 ? "-o" + std::to_string(index) : "--option-" + std::to_string(index));
+        switch (index % 4) {
+            case 0: argv.push_back(std::to_string(index * 7)); break;
+            case 1: argv.push_back(index % 8 == 1 ? "fast" : "value-" + std::to_string(index)); break;
+            case 2: break;
+            case 3: argv.push_back(std::to_string(index) + ".25"); break;
+        }
+    }
+    return argv;
+}
+
+std::vector<const char*> as_pointers(const std::vector<std::string>& args) {
+    std::vector<const char*> pointers;
+    for (const auto& arg : args) pointers.push_back(arg.c_str());
+    return pointers;
+}
+
+}
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser cli("parse_benchmarks");
+    cli.auto_help(false);
+    cli.add_argument("filter").type_string().default_value("").add_alias("f")
+        .help("Only run benchmarks whose name contains this text");
+    cli.add_argument("min-time").type_int().default_value(100).min_value(1).add_alias("t")
+        .help("Minimum measured time per benchmark in milliseconds");
+    cli.add_argument("csv").flag().help("Print results as CSV");
+
+    const auto options = cli.parse_args(argc, argv);
+    const std::string filter = options.get<std::string>("filter");
+    const std::chrono::milliseconds min_time(options.get<int>("min-time"));
+    const bool csv = options.get<bool>("csv");
+
+    if (csv) std::printf("benchmark,arguments,argv,ns_per_op,allocs_per_op\n");
+    else std::printf("%-12s %9s %7s %14s %12s\n", "benchmark", "arguments", "argv", "ns/op", "allocs/op");
+
+    auto report = [&](const char* name, size_t count, size_t tokens, auto&& fn) {
+        if (!filter.empty() && std::string(name).find(filter) == std::string::npos) return;
+        const Measurement m = measure(fn, min_time);
+        if (csv) std::printf("%s,%zu,%zu,%.1f,%.2f\n", name, count, tokens, m.ns_per_op, m.allocs_per_op);
+        else std::printf("%-12s %9zu %7zu %14.1f %12.2f\n", name, count, tokens, m.ns_per_op, m.allocs_per_op);
+    };
+
+    for (size_t count : { 10, 100, 1000 }) {
+        const auto tokens = build_argv(count);
+        const auto pointers = as_pointers(tokens);
+        const int token_count = static_cast<int>(pointers.size());
+
+        report("cold_parse", count, pointers.size(), [&] {
+            argparse::ArgumentParser parser("bench");
+            build_schema(parser, count);
+            auto args = parser.parse_args(token_count, const_cast<char**>(pointers.data()));
+            keep(args);
+        });
+
+        argparse::ArgumentParser parser("bench");
+        build_schema(parser, count);
+        parser.compile();
+
+        report("warm_parse", count, pointers.size(), [&] {
+            auto result = parser.parse(token_count, pointers.data());
+            keep(result);
+        });
+
+        // The same command line parsed lazily by a program that reads five of the options.
+        argparse::ArgumentParser deferred("bench");
+        build_schema(deferred, count);
+        deferred.lazy().compile();
+
+        report("lazy_parse", count, pointers.size(), [&] {
+            auto result = deferred.parse(token_count, pointers.data());
+            const auto& args = result.args();
+            float sum = static_cast<float>(args.get<int>("option-0") + args.get<int>("option-4")) + args.get<float>("option-3");
+            keep(sum);
+            keep(args.get<std::string_view>("option-1"));
+            keep(args.get<bool>("option-2"));
+        });
+
+        // A large schema with almost everything left to defaults, as most invocations are.
+        const char* sparse_argv[] = { "bench", "--option-1", "fast", "--option-2" };
+        report("sparse_parse", count, 4, [&] {
+            auto result = parser.parse(4, sparse_argv);
+            keep(result);
+        });
+
+        // Every setting also present in a config file, with env() read from a snapshot.
+        std::string config_text;
+        for (size_t i = 0; i < count; ++i) {
+            config_text += "option-" + std::to_string(i) + " = ";
+            switch (i % 4) {
+                case 0: config_text += std::to_string(i); break;
+                case 1: config_text += i % 8 == 1 ? "small" : "from-config"; break;
+                case 2: config_text += "true"; break;
+                case 3: config_text += "0.5"; break;
+            }
+            config_text += '\n';
+        }
+        argparse::ArgumentParser layered("bench");
+        build_schema(layered, count);
+        layered.env_snapshot(argparse::EnvSnapshot::capture());
+        layered.config(argparse::ConfigFile::from_string(config_text));
+        layered.compile();
+
+        report("layered", count, pointers.size(), [&] {
+            auto result = layered.parse(token_count, pointers.data());
+            keep(result);
+        });
+
+        // What parse_cached() does on a hit, minus mapping the cache file.
+        const uint64_t input_key = *parser.input_hash(token_count, pointers.data());
+        const std::string snapshot = parser.snapshot(parser.parse(token_count, pointers.data()).args(), input_key);
+
+        report("restore", count, pointers.size(), [&] {
+            auto key = parser.input_hash(token_count, pointers.data());
+            auto restored = parser.restore(snapshot, *key);
+            keep(restored);
+        });
+
+        // The same command line with one value that fails conversion at the end.
+        auto bad_tokens = tokens;
+        bad_tokens.push_back("--option-0");
+        bad_tokens.push_back("not-a-number");
+        const auto bad_pointers = as_pointers(bad_tokens);
+        const int bad_count = static_cast<int>(bad_pointers.size());
+
+        report("try_reject", count, bad_pointers.size(), [&] {
+            auto result = parser.try_parse_args(bad_count, bad_pointers.data());
+            keep(result);
+        });
+
+        report("throw_reject", count, bad_pointers.size(), [&] {
+            try {
+                auto args = parser.parse_args(bad_count, const_cast<char**>(bad_pointers.data()));
+                keep(args);
+            }
+            catch (const argparse::ArgumentError& e) {
+                keep(e);
+            }
+        });
+
+        const auto args = parser.parse(token_count, pointers.data()).args();
+        std::vector<std::string> names;
+        for (size_t i = 0; i < count; i += 4) names.push_back("option-" + std::to_string(i));
+
+        report("get_by_name", count, pointers.size(), [&] {
+            int sum = 0;
+            for (const auto& name : names) sum += args.get<int>(name);
+            keep(sum);
+        });
+
+        std::vector<argparse::ArgKey<int>> keys;
+        for (size_t i = 0; i < count; i += 4) keys.emplace_back(parser.arguments()[i]);
+
+        report("get_by_key", count, pointers.size(), [&] {
+            int sum = 0;
+            for (const auto& key : keys) sum += args[key];
+            keep(sum);
+        });
+
+        // What `--complete --option-1` answers when Tab is pressed.
+        const std::string_view partial[] = { "--option-1" };
+        report("complete", count, 1, [&] {
+            auto candidates = parser.complete(partial);
+            keep(candidates);
+        });
+
+        report("help", count, pointers.size(), [&] {
+            auto text = parser.help();
+            keep(text);
+        });
+
+        report("write_help", count, pointers.size(), [&] {
+            DiscardBuffer buffer;
+            std::ostream out(&buffer);
+            parser.write_help(out, argparse::HelpLayout::ALIGNED);
+            keep(buffer);
+        });
+    }
+
+    // Many short command lines against one schema, as a submission gateway validates them.
+    constexpr size_t batch_size = 10000;
+    {
+        argparse::ArgumentParser parser("bench");
+        build_schema(parser, 10);
+        parser.compile();
+        const auto tokens = build_argv(10);
+        const std::vector<std::string_view> line(tokens.begin() + 1, tokens.end());
+        const std::vector<std::vector<std::string_view>> lines(batch_size, line);
+
+        report("batch", 10, batch_size, [&] {
+            auto batch = parser.parse_batch(lines);
+            keep(batch);
+        });
+        report("batch_par", 10, batch_size, [&] {
+            auto batch = parser.parse_batch(lines, 0);
+            keep(batch);
+        });
+    }
+
+    const std::vector<std::string> auto_values{ "42", "-7", "3.5", "true", "0", "release", "eu-west-1", "1e6" };
+    report("auto_convert", auto_values.size(), auto_values.size(), [&] {
+        for (const auto& value : auto_values) {
+            auto converted = argparse::Argument::convert_value(value, argparse::Argument::ArgType::AUTO);
+            keep(converted);
+        }
+    });
+
+    // One delimited value holding many numbers, as in `--weights 0.1,0.2,...`.
+    constexpr size_t list_size = 100000;
+    constexpr const char* size_units[] = { "", "KiB", "MiB", "GB" };
+    std::string int_list, float_list, size_list;
+    for (size_t i = 0; i < list_size; ++i) {
+        if (i) { int_list += ','; float_list += ','; size_list += ','; }
+        int_list += std::to_string(i * 37 % 1000000);
+        float_list += std::to_string(i % 1000) + ".125";
+        size_list += std::to_string(i % 4096) + size_units[i % 4];
+    }
+
+    argparse::ArgumentParser lists("bench");
+    lists.auto_help(false);
+    lists.add_argument("ids").type_int().delimiter(',').min_value(0).max_value(1000000);
+    lists.add_argument("weights").type_float().delimiter(',');
+    lists.add_argument("buffers").type_size().delimiter(',').max_value(uint64_t(1) << 40);
+    lists.compile();
+
+    const char* int_argv[] = { "bench", "--ids", int_list.c_str() };
+    report("int_list", 1, list_size, [&] {
+        auto result = lists.parse(3, int_argv);
+        keep(result);
+    });
+
+    const char* float_argv[] = { "bench", "--weights", float_list.c_str() };
+    report("float_list", 1, list_size, [&] {
+        auto result = lists.parse(3, float_argv);
+        keep(result);
+    });
+
+    const char* size_argv[] = { "bench", "--buffers", size_list.c_str() };
+    report("size_list", 1, list_size, [&] {
+        auto result = lists.parse(3, size_argv);
+        keep(result);
+    });
+}
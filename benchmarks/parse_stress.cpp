@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "arg_parser.hpp"
+
+// Adversarial scaling checks: each scenario is timed at a base size and at
+// `growth` times that size, and the time per unit (token, byte or argument)
+// of the two is compared. Linear work keeps the ratio near 1, and below 4
+// even when the large size no longer fits in cache; quadratic work grows it
+// by about `growth`. A ratio above --max-ratio fails the run, which catches
+// such behaviour in the tokenizer, the value store or the error path before
+// it ships.
+
+namespace {
+
+struct Scenario {
+    const char* name;
+    const char* unit;
+    // Builds the schema and command line for size `n`, and returns how many units they hold.
+    std::function<size_t(size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv)> build;
+    // False for scenarios whose command line is meant to be rejected.
+    bool accepts = true;
+};
+
+// A schema of `count` arguments with every feature a parse has to consult.
+void random_schema(argparse::ArgumentParser& parser, size_t count, std::mt19937& rng) {
+    parser.auto_help(false);
+    for (size_t i = 0; i < count; ++i) {
+        auto& arg = parser.add_argument("opt-" + std::to_string(i));
+        switch (rng() % 5) {
+            case 0: arg.type_int(); break;
+            case 1: arg.type_string(); break;
+            case 2: arg.flag(); break;
+            case 3: arg.type_double(); break;
+            case 4: arg.type_string().choices({ "red", "green", "blue" }); break;
+        }
+        if (rng() % 4 == 0) arg.add_alias("x" + std::to_string(i));
+        if (rng() % 16 == 0) arg.env("ARGPARSE_STRESS_UNSET_" + std::to_string(i));
+    }
+}
+
+std::string value_for(const argparse::Argument& arg, size_t i) {
+    if (!arg.choices().empty()) return arg.choices()[i % arg.choices().size()];
+    switch (arg.type()) {
+        case argparse::Argument::ArgType::INT: return std::to_string(i % 100000);
+        case argparse::Argument::ArgType::DOUBLE: return std::to_string(i) + ".5";
+        default: return "value-" + std::to_string(i);
+    }
+}
+
+std::vector<Scenario> scenarios(uint32_t seed) {
+    std::vector<Scenario> list;
+
+    list.push_back({ "distinct", "token", [seed](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        std::mt19937 rng(seed);
+        random_schema(parser, n / 2, rng);
+        for (size_t i = 0; i < n / 2; ++i) {
+            const auto& arg = parser.arguments()[i];
+            argv.push_back("--" + std::string(arg.name()));
+            if (!arg.is_flag()) argv.push_back(value_for(arg, i));
+        }
+        return argv.size() - 1;
+    } });
+
+    // The same option over and over; only the last occurrence is kept.
+    list.push_back({ "repeated", "token", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false);
+        parser.add_argument("count").type_int();
+        for (size_t i = 0; i < n / 2; ++i) {
+            argv.push_back("--count");
+            argv.push_back(std::to_string(i));
+        }
+        return argv.size() - 1;
+    } });
+
+    // Every occurrence of an append option is kept.
+    list.push_back({ "appended", "token", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false);
+        parser.add_argument("tag").type_string().append();
+        for (size_t i = 0; i < n / 2; ++i) {
+            argv.push_back("--tag");
+            argv.push_back("t" + std::to_string(i));
+        }
+        return argv.size() - 1;
+    } });
+
+    list.push_back({ "huge_token", "byte", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false);
+        parser.add_argument("blob").type_string();
+        argv.push_back("--blob");
+        argv.push_back(std::string(n * 64, 'z'));
+        return n * 64;
+    } });
+
+    list.push_back({ "huge_list", "element", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false);
+        parser.add_argument("ids").type_int().delimiter(',');
+        std::string ids;
+        for (size_t i = 0; i < n; ++i) ids += (i ? "," : "") + std::to_string(i % 1000);
+        argv.push_back("--ids");
+        argv.push_back(std::move(ids));
+        return n;
+    } });
+
+    // Unique abbreviations of long names in a schema where they all share a prefix.
+    list.push_back({ "abbreviated", "token", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false).allow_abbrev();
+        for (size_t i = 0; i < n; ++i) parser.add_argument("shared-prefix-" + std::to_string(i) + "-option").flag();
+        for (size_t i = 0; i < n; ++i) argv.push_back("--shared-prefix-" + std::to_string(i) + "-");
+        return n;
+    } });
+
+    // A schema the command line leaves entirely to defaults and env() fallbacks.
+    list.push_back({ "defaults", "argument", [seed](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>&) {
+        std::mt19937 rng(seed + 1);
+        random_schema(parser, n, rng);
+        return n;
+    } });
+
+    // Unknown options fill the rest of the command line after the first error.
+    list.push_back({ "unknown", "token", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false);
+        parser.add_argument("known").flag();
+        for (size_t i = 0; i < n; ++i) argv.push_back("--unknown-" + std::to_string(i));
+        return n;
+    }, false });
+
+    // A rejected value among many choices, with its error message built.
+    list.push_back({ "bad_choice", "choice", [](size_t n, argparse::ArgumentParser& parser, std::vector<std::string>& argv) {
+        parser.auto_help(false);
+        std::vector<std::string> choices;
+        for (size_t i = 0; i < n; ++i) choices.push_back("choice-" + std::to_string(i));
+        parser.add_argument("pick").choices(std::move(choices));
+        argv.push_back("--pick");
+        argv.push_back("none-of-them");
+        return n;
+    }, false });
+
+    return list;
+}
+
+struct Timing {
+    double ns_per_unit;        // Median over the repetitions.
+    double worst_ns_per_unit;  // Slowest repetition.
+};
+
+// Times parse() plus, for rejected command lines, building the error message.
+Timing time_parse(const argparse::ArgumentParser& parser, const std::vector<std::string>& argv, size_t units, int repetitions, bool& accepted) {
+    std::vector<const char*> pointers;
+    for (const auto& token : argv) pointers.push_back(token.c_str());
+
+    std::vector<double> runs;
+    for (int r = 0; r < repetitions; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = parser.parse(static_cast<int>(pointers.size()), pointers.data());
+        if (!result) {
+            const std::string message = result.error();
+            accepted = message.empty();
+        }
+        else {
+            accepted = true;
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        runs.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(units));
+    }
+    std::sort(runs.begin(), runs.end());
+    return { runs[runs.size() / 2], runs.back() };
+}
+
+}
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser cli("parse_stress");
+    cli.auto_help(false);
+    cli.add_argument("size").type_size().default_value(uint64_t(1) << 14).min_value(uint64_t(16))
+        .help("Base size of every scenario; the large run is --growth times bigger");
+    cli.add_argument("growth").type_int().default_value(16).min_value(2)
+        .help("Ratio between the large and the base size");
+    cli.add_argument("max-ratio").type_double().default_value(6.0)
+        .help("Fail if time per unit grows by more than this from the base to the large size");
+    cli.add_argument("repetitions").type_int().default_value(5).min_value(1).add_alias("r");
+    cli.add_argument("seed").type_uint64().default_value(uint64_t(1));
+    cli.add_argument("filter").type_string().default_value("").add_alias("f")
+        .help("Only run scenarios whose name contains this text");
+
+    const auto options = cli.parse_args(argc, argv);
+    const size_t base = options.get<uint64_t>("size");
+    const size_t growth = static_cast<size_t>(options.get<int>("growth"));
+    const double max_ratio = options.get<double>("max-ratio");
+    const int repetitions = options.get<int>("repetitions");
+    const std::string filter = options.get<std::string>("filter");
+
+    std::printf("%-12s %-8s %12s %12s %14s %8s\n", "scenario", "unit", "base ns/u", "large ns/u", "worst ns/u", "ratio");
+    bool failed = false;
+    for (const auto& scenario : scenarios(static_cast<uint32_t>(options.get<uint64_t>("seed")))) {
+        if (!filter.empty() && std::string(scenario.name).find(filter) == std::string::npos) continue;
+
+        Timing timings[2];
+        for (int pass = 0; pass < 2; ++pass) {
+            argparse::ArgumentParser parser("stress");
+            std::vector<std::string> tokens{ "stress" };
+            const size_t units = scenario.build(pass ? base * growth : base, parser, tokens);
+            parser.compile();
+            bool accepted = false;
+            timings[pass] = time_parse(parser, tokens, std::max<size_t>(units, 1), repetitions, accepted);
+            if (accepted != scenario.accepts) {
+                std::printf("%-12s parse was %s, expected it to be %s\n", scenario.name,
+                    accepted ? "accepted" : "rejected", scenario.accepts ? "accepted" : "rejected");
+                failed = true;
+            }
+        }
+
+        const double ratio = timings[1].ns_per_unit / timings[0].ns_per_unit;
+        const bool slow = ratio > max_ratio;
+        failed |= slow;
+        std::printf("%-12s %-8s %12.2f %12.2f %14.2f %8.2f%s\n", scenario.name, scenario.unit, timings[0].ns_per_unit,
+            timings[1].ns_per_unit, timings[1].worst_ns_per_unit, ratio, slow ? "  SUPERLINEAR" : "");
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "arg_parser.hpp"
+
+// e.g. batch jobs.txt, where each line is one submission such as `--queue gpu --cpus 8 --tag a,b`
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: batch <file with one command line per line>\n";
+        return 1;
+    }
+
+    argparse::ArgumentParser parser("submit");
+    parser.auto_help(false);
+
+    argparse::ArgKey<std::string> queue = parser.add_argument("queue")
+        .type_string()
+        .choices({ "cpu", "gpu" })
+        .default_value("cpu");
+
+    argparse::ArgKey<int> cpus = parser.add_argument("cpus")
+        .type_int()
+        .default_value(1)
+        .min_value(1)
+        .max_value(256);
+
+    argparse::ListKey<std::string_view> tags = parser.add_argument("tag")
+        .type_string()
+        .delimiter(',');
+
+    parser.compile();
+
+    std::ifstream in(argv[1]);
+    std::vector<std::string> words;
+    std::vector<std::vector<std::string_view>> lines;
+    std::vector<size_t> ends;
+    for (std::string text; std::getline(in, text);) {
+        std::istringstream split(text);
+        for (std::string word; split >> word;) words.push_back(word);
+        ends.push_back(words.size());
+    }
+    for (size_t i = 0, begin = 0; i < ends.size(); begin = ends[i++]) {
+        lines.emplace_back(words.begin() + static_cast<std::ptrdiff_t>(begin), words.begin() + static_cast<std::ptrdiff_t>(ends[i]));
+    }
+
+    // 0 spreads the lines over every hardware thread.
+    const argparse::BatchResult batch = parser.parse_batch(lines, 0);
+
+    for (const auto& failure : batch.errors()) {
+        std::cerr << "line " << failure.row + 1 << ": " << failure.error.message() << "\n";
+    }
+
+    long total_cpus = 0;
+    size_t gpu_jobs = 0, tagged = 0;
+    const auto queues = batch[queue];
+    const auto counts = batch[cpus];
+    for (size_t row = 0; row < batch.size(); ++row) {
+        if (!batch.ok(row)) continue;
+        total_cpus += counts[row];
+        gpu_jobs += queues[row] == "gpu";
+        tagged += !batch.list(tags, row).empty();
+    }
+    std::cout << batch.size() - batch.errors().size() << " valid jobs, " << gpu_jobs << " on gpu, "
+              << tagged << " tagged, " << total_cpus << " cpus requested\n";
+    return batch.errors().empty() ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+// Settings come from argv first, then the environment, then service.ini, then defaults:
+//
+//     # service.ini
+//     port = 8080
+//     log-level = info
+//     [migrate]
+//     dry-run = true
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("config_file");
+    parser.auto_help(false);
+
+    parser.add_argument("port")
+        .type_int()
+        .help("Port to listen on")
+        .min_value(1)
+        .max_value(65535)
+        .env("SERVICE_PORT")
+        .default_value(80);
+
+    parser.add_argument("log-level")
+        .help("Log verbosity")
+        .choices({ "debug", "info", "warning" })
+        .default_value("warning");
+
+    parser.add_subcommand("migrate", [](argparse::ArgumentParser& migrate) {
+        migrate.add_argument("dry-run").flag().help("Only print the migration plan");
+    });
+
+    try {
+        if (auto config = argparse::ConfigFile::open("service.ini")) {
+            parser.config(std::move(*config));
+        }
+        auto args = parser.parse_args(argc, argv);
+
+        std::cout << "port: " << args.get<int>("port") << "\n";
+        std::cout << "log-level: " << args.get<std::string>("log-level") << "\n";
+        if (args.subcommand() == "migrate") {
+            std::cout << "dry-run: " << args.subcommand_args().get<bool>("dry-run") << "\n";
+        }
+    }
+    catch (const argparse::ArgumentError& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+}
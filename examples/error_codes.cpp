@@ -0,0 +1,36 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("error_codes");
+
+    parser.add_argument("level")
+        .type_int()
+        .help("Compression level")
+        .min_value(1)
+        .max_value(9)
+        .default_value(6);
+
+    parser.add_argument("format")
+        .help("Archive format")
+        .choices({ "tar", "zip" })
+        .default_value("tar");
+
+    auto args = parser.try_parse_args(argc, argv);
+    if (!args) {
+        const argparse::ParseError& error = args.error();
+        if (error.code() == argparse::ParseError::Code::HELP_REQUESTED) {
+            error.parser()->write_help(std::cout);
+            return 0;
+        }
+
+        std::cerr << "Argument error: " << error.message() << "\n";
+        if (error.token_position() != argparse::ParseError::npos) {
+            std::cerr << "  at argv[" << error.token_position() + 1 << "]\n";
+        }
+        return 2;
+    }
+
+    std::cout << "level: " << args->get<int>("level") << "\n";
+    std::cout << "format: " << args->get<std::string>("format") << "\n";
+}
@@ -0,0 +1,36 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("list_values");
+
+    argparse::ListKey<std::string_view> files = parser.add_argument("files")
+        .type_string()
+        .help("Files to process")
+        .nargs(1, argparse::Argument::unbounded)
+        .required();
+
+    argparse::ListKey<int> ports = parser.add_argument("port")
+        .type_int()
+        .help("Port to listen on; repeat or separate with commas")
+        .append()
+        .delimiter(',')
+        .min_value(1)
+        .max_value(65535)
+        .add_alias("p");
+
+    try {
+        auto args = parser.parse_args(argc, argv);
+
+        for (std::string_view file : args[files]) {
+            std::cout << "file: " << file << "\n";
+        }
+        for (int port : args[ports]) {
+            std::cout << "port: " << port << "\n";
+        }
+    }
+    catch (const argparse::ArgumentError& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,37 @@
+#include <cstdlib>
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("snapshot_cache");
+    parser.auto_help(false);
+
+    parser.add_argument("target")
+        .type_string()
+        .help("Deployment target")
+        .choices({ "staging", "production" })
+        .env("DEPLOY_TARGET")
+        .default_value("staging");
+
+    parser.add_argument("hosts")
+        .type_string()
+        .help("Hosts to deploy to, separated by commas")
+        .delimiter(',');
+    parser.compile();
+
+    // The same command line and environment reuse the previous run's values as they are.
+    const char* cache = std::getenv("SNAPSHOT_CACHE");
+    if (!cache) cache = "snapshot_cache.bin";
+
+    auto result = parser.parse_cached(argc, argv, cache);
+    if (!result) {
+        std::cerr << "Argument error: " << result.error() << "\n";
+        return 1;
+    }
+
+    const auto& args = result.args();
+    std::cout << "target: " << args.get<std::string>("target") << "\n";
+    for (std::string_view host : args.get_list<std::string_view>("hosts")) {
+        std::cout << "host: " << host << "\n";
+    }
+}
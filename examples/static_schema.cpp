@@ -0,0 +1,28 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+using namespace argparse;
+
+using Cli = StaticParser<
+    Arg<"color", std::string_view, Alias<"c">, Help<"Color to use">,
+        Choices<"RED", "GREEN", "BLUE">, DefaultText<"RED">>,
+    Arg<"count", int, Help<"Number of times to repeat">, Required, Min<1>, Max<10>>,
+    Arg<"debug", Flag, Alias<"d">, Help<"Enable debug mode">>>;
+
+int main(int argc, char** argv) {
+    try {
+        auto args = Cli::parse(argc, argv);
+        if (args.help_requested()) {
+            std::cout << Cli::help("static_schema");
+            return 0;
+        }
+
+        std::cout << "Color: " << args.get<"color">() << "\n";
+        std::cout << "Count: " << args.get<"count">() << "\n";
+        std::cout << "Debug: " << std::boolalpha << args.get<"debug">() << "\n";
+    }
+    catch (const ArgumentError& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+}
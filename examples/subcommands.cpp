@@ -0,0 +1,50 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("subcommands");
+
+    // `subcommands --complete log -` lists log's options;
+    // `source <(subcommands --completion-script bash)` installs Tab completion.
+    parser.completion();
+
+    parser.add_argument("verbose")
+        .help("Print more output")
+        .flag();
+
+    // Each builder only runs when its subcommand is selected.
+    parser.add_subcommand("add", [](argparse::ArgumentParser& add) {
+        add.add_argument("path")
+            .type_string()
+            .help("File to add")
+            .required();
+    }, "Add a file");
+
+    parser.add_subcommand("log", [](argparse::ArgumentParser& log) {
+        log.auto_help(false);
+        log.add_argument("limit")
+            .type_int()
+            .help("Number of entries to show")
+            .default_value(10)
+            .min_value(1)
+            .add_alias("n");
+    }, "Show recent entries");
+
+    try {
+        auto args = parser.parse_args(argc, argv);
+
+        if (args.subcommand() == "add") {
+            std::cout << "Adding " << args.subcommand_args().get<std::string>("path") << "\n";
+        }
+        else if (args.subcommand() == "log") {
+            std::cout << "Showing " << args.subcommand_args().get<int>("limit") << " entries\n";
+        }
+        else if (args.get<bool>("verbose")) {
+            std::cout << "No subcommand given\n";
+        }
+    }
+    catch (const argparse::ArgumentError& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,35 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("typed_keys");
+
+    argparse::ArgKey<std::string> name = parser.add_argument("name")
+        .type_string()
+        .help("Name to greet")
+        .default_value("world")
+        .add_alias("n");
+
+    argparse::ArgKey<int> times = parser.add_argument("times")
+        .type_int()
+        .help("Number of greetings")
+        .default_value(1)
+        .min_value(1)
+        .max_value(100);
+
+    argparse::ArgKey<bool> shout = parser.add_argument("shout")
+        .help("Greet loudly")
+        .flag();
+
+    try {
+        auto args = parser.parse_args(argc, argv);
+
+        for (int i = 0; i < args[times]; ++i) {
+            std::cout << (args[shout] ? "HELLO, " : "Hello, ") << args[name] << "\n";
+        }
+    }
+    catch (const argparse::ArgumentError& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+}
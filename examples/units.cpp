@@ -0,0 +1,40 @@
+#include <chrono>
+#include <iostream>
+#include "arg_parser.hpp"
+
+using namespace std::chrono_literals;
+
+// e.g. units --cache 64GiB --timeout 1m30s --offset 9000000000
+int main(int argc, char** argv) {
+    argparse::ArgumentParser parser("units");
+
+    argparse::ArgKey<uint64_t> cache = parser.add_argument("cache")
+        .type_size()
+        .help("Cache size, e.g. 512MiB or 64GiB")
+        .default_value(uint64_t(1) << 30)
+        .min_value(uint64_t(1) << 20);
+
+    argparse::ArgKey<std::chrono::milliseconds> timeout = parser.add_argument("timeout")
+        .type_duration()
+        .help("Request timeout, e.g. 250ms or 1m30s")
+        .default_value(30s)
+        .max_value(1h);
+
+    argparse::ArgKey<int64_t> offset = parser.add_argument("offset")
+        .type_int64()
+        .help("Byte offset to start reading at")
+        .default_value(0)
+        .min_value(0);
+
+    try {
+        auto args = parser.parse_args(argc, argv);
+
+        std::cout << "cache: " << args[cache] << " bytes\n";
+        std::cout << "timeout: " << args[timeout].count() << " ms\n";
+        std::cout << "offset: " << args[offset] << "\n";
+    }
+    catch (const argparse::ArgumentError& e) {
+        std::cerr << "Argument error: " << e.what() << "\n";
+        return 1;
+    }
+}
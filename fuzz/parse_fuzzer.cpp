@@ -0,0 +1,202 @@
+// Fuzz target for the parser: the input describes a schema and a command line.
+//
+// Built with clang, this is a libFuzzer target:
+//     cmake -S . -B build -DCMAKE_CXX_COMPILER=clang++ -DARGPARSE_BUILD_FUZZERS=ON
+//     build/fuzz/parse_fuzzer -max_len=4096 corpus/
+// With other compilers it is built with ARGPARSE_FUZZ_STANDALONE and replays the
+// files named on the command line, or stdin, which also suits AFL++ (afl-g++).
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "arg_parser.hpp"
+
+namespace {
+
+// Hands out the input a byte at a time; once it runs out every byte is zero.
+struct Input {
+    const uint8_t* data;
+    size_t size;
+
+    uint8_t byte() {
+        if (size == 0) return 0;
+        --size;
+        return *data++;
+    }
+
+    std::string_view rest() const {
+        return { reinterpret_cast<const char*>(data), size };
+    }
+};
+
+// Aborts so the fuzzer records the input; used for broken invariants, not rejected input.
+void require(bool condition, const char* what) {
+    if (condition) return;
+    std::fprintf(stderr, "invariant broken: %s\n", what);
+    std::abort();
+}
+
+constexpr const char* choice_pool[] = { "a", "bb", "ccc", "1", "-2", "2.5", "10s", "4KiB", "true", "" };
+
+// Declares 1 to 16 arguments, each shaped by a few bytes of the input.
+void build_schema(argparse::ArgumentParser& parser, Input& in) {
+    parser.auto_help(false);
+    const uint8_t settings = in.byte();
+    parser.allow_abbrev(settings & 1);
+    const size_t count = 1 + in.byte() % 16;
+    for (size_t i = 0; i < count; ++i) {
+        auto& arg = parser.add_argument("o" + std::to_string(i));
+        const uint8_t kind = in.byte();
+        const uint8_t bits = in.byte();
+        switch (kind % 11) {
+            case 0: arg.type_int(); break;
+            case 1: arg.type_float(); break;
+            case 2: arg.type_string(); break;
+            case 3: arg.type_bool(); break;
+            case 4: break;
+            case 5: arg.type_int64(); break;
+            case 6: arg.type_uint64(); break;
+            case 7: arg.type_double(); break;
+            case 8: arg.type_duration(); break;
+            case 9: arg.type_size(); break;
+            case 10: arg.flag(); break;
+        }
+        // Aliases are drawn from a small alphabet, so duplicates are exercised too.
+        if (bits & 1) arg.add_alias(std::string(1, static_cast<char>('a' + in.byte() % 26)));
+        if (bits & 2) {
+            std::vector<std::string> choices;
+            for (size_t c = in.byte() % 4 + 1; c > 0; --c) choices.emplace_back(choice_pool[in.byte() % std::size(choice_pool)]);
+            arg.choices(std::move(choices));
+        }
+        if (bits & 4) arg.env("ARGPARSE_FUZZ_" + std::to_string(in.byte() % 4));
+        if (bits & 8) arg.delimiter(',');
+        if (bits & 16) arg.nargs(in.byte() % 3, 1 + in.byte() % 4);
+        if (bits & 32) arg.append();
+        if (bits & 64) arg.required();
+        if ((bits & 128) && kind % 11 == 0) arg.min_value(-100).max_value(100);
+    }
+}
+
+void run(const uint8_t* data, size_t size) {
+    Input in{ data, size };
+    argparse::ArgumentParser parser("fuzz");
+    try {
+        build_schema(parser, in);
+        parser.compile();
+    }
+    catch (const argparse::ArgumentError&) {
+        return;
+    }
+
+    // The rest of the input is the command line, one token per line.
+    std::vector<std::string> tokens{ "fuzz" };
+    const std::string_view rest = in.rest();
+    for (size_t start = 0; start <= rest.size();) {
+        const size_t end = std::min(rest.find('\n', start), rest.size());
+        tokens.emplace_back(rest.substr(start, end - start));
+        start = end + 1;
+    }
+    std::vector<const char*> argv;
+    std::vector<char*> mutable_argv;
+    for (auto& token : tokens) {
+        argv.push_back(token.c_str());
+        mutable_argv.push_back(token.data());
+    }
+    const int argc = static_cast<int>(argv.size());
+
+    const argparse::ParseResult result = parser.parse(argc, argv.data());
+    const auto expected = parser.try_parse_args(argc, argv.data());
+    require(bool(result) == expected.has_value(), "parse and try_parse_args agree");
+    if (!result && !result.help_requested()) {
+        require(!result.error().empty(), "errors have a message");
+        require(result.parse_error().code() == expected.error().code(), "both report the same error");
+    }
+
+    // parse_args prints and exits on a help request, so only call it when there is none.
+    if (!result.help_requested()) {
+        try {
+            const argparse::ParsedArgs args = parser.parse_args(argc, mutable_argv.data());
+            require(bool(result), "parse_args accepts what parse accepts");
+            require(args.size() == parser.arguments().size(), "one value per argument");
+        }
+        catch (const argparse::ArgumentError&) {
+            require(!result, "parse_args rejects what parse rejects");
+        }
+    }
+
+    // A lazy parse accepts at least as much, and validating it rejects exactly what an eager parse does.
+    argparse::ArgumentParser lazy = parser;
+    lazy.lazy().compile();
+    const argparse::ParseResult deferred = lazy.parse(argc, argv.data());
+    if (result) require(bool(deferred), "lazy parse accepts what an eager one does");
+    if (deferred) {
+        bool valid = true;
+        try {
+            deferred.args().validate_all();
+        }
+        catch (const argparse::ArgumentError&) {
+            valid = false;
+        }
+        if (!result.help_requested()) require(valid == bool(result), "validate_all matches the eager parse");
+    }
+
+    if (result) {
+        if (auto key = parser.input_hash(argc, argv.data())) {
+            const std::string blob = parser.snapshot(result.args(), *key);
+            require(parser.restore(blob, *key).has_value(), "a snapshot restores");
+            require(!parser.restore(blob, *key + 1).has_value(), "a snapshot is bound to its input");
+        }
+    }
+
+    // Every token against every conversion and every argument's validation.
+    for (size_t i = 1; i < tokens.size() && i < 64; ++i) {
+        for (int type = 0; type <= static_cast<int>(argparse::Argument::ArgType::SIZE); ++type) {
+            try {
+                argparse::Argument::convert_value(tokens[i], static_cast<argparse::Argument::ArgType>(type));
+            }
+            catch (const argparse::ArgumentError&) {
+            }
+        }
+        for (const auto& arg : parser.arguments()) {
+            try {
+                arg.validate(tokens[i]);
+            }
+            catch (const argparse::ArgumentError&) {
+            }
+        }
+    }
+
+    std::vector<std::string_view> words(tokens.begin() + 1, tokens.end());
+    (void)parser.complete(words);
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    run(data, size);
+    return 0;
+}
+
+#ifdef ARGPARSE_FUZZ_STANDALONE
+int main(int argc, char** argv) {
+    auto replay = [](std::istream& in) {
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    };
+    if (argc < 2) replay(std::cin);
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        replay(file);
+    }
+}
+#endif
@@ -1,15 +1,103 @@
 ﻿#pragma once
 
+#include "arg_parser_fwd.hpp"
+
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <unordered_map>
 #include <stdexcept>
 #include <functional>
 #include <variant>
 #include <optional>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <memory>
+#include <memory_resource>
+#include <cstring>
+#include <type_traits>
 #include <algorithm>
+#include <numeric>
+#include <charconv>
 #include <cstdlib>
-#include <sstream>
+#include <cctype>
+#include <istream>
+#include <ostream>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <iterator>
+#include <span>
+#include <limits>
+#include <bit>
+#include <exception>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#if __has_include(<sys/mman.h>)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ARGPARSE_HAS_MMAP 1
+#else
+#include <fstream>
+#define ARGPARSE_HAS_MMAP 0
+#endif
+
+#if !defined(_WIN32)
+extern "C" char** environ;
+#endif
+
+// Set ARGPARSE_INSTRUMENTATION to 1 to collect per-phase timings and allocation
+// counts (see ParseStats). When 0 the hooks compile to nothing. With CMake, use
+// the option of the same name so argparse::argparse and its users agree.
+#ifndef ARGPARSE_INSTRUMENTATION
+#define ARGPARSE_INSTRUMENTATION 0
+#endif
+
+// Set by the argparse::argparse library target. The parser's entry points and the
+// templates listed in ARGPARSE_INSTANTIATIONS are then compiled once, in the
+// library, and only declared here.
+#ifndef ARGPARSE_COMPILED
+#define ARGPARSE_COMPILED 0
+#endif
+
+#if ARGPARSE_COMPILED
+#define ARGPARSE_INLINE
+#else
+#define ARGPARSE_INLINE inline
+#endif
+
+// Only the out-of-class definitions need these, so users of the library do not pay for them.
+#if !ARGPARSE_COMPILED || defined(ARGPARSE_BUILDING_LIBRARY)
+#include <iostream>
+#include <thread>
+#endif
+
+// Vector width used to scan delimited list values; define ARGPARSE_NO_SIMD to force the scalar path.
+#if defined(ARGPARSE_NO_SIMD)
+#define ARGPARSE_SIMD_WIDTH 0
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define ARGPARSE_SIMD_WIDTH 32
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARGPARSE_SIMD_WIDTH 16
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ARGPARSE_SIMD_WIDTH 16
+#else
+#define ARGPARSE_SIMD_WIDTH 0
+#endif
 
 namespace argparse
 {
@@ -19,566 +107,6747 @@ namespace argparse
 		using std::runtime_error::runtime_error;
 	};
 
+	class ArgumentParser;
+
 	/**
-	 * @brief Represents a command-line argument with metadata and validation.
+	 * @brief Why a parse failed, recorded without formatting any text.
 	 *
-	 * Supports various data types, default values,
-	 * choices, flags, and custom validation logic.
+	 * Holds a code, the index of the argument involved and the position of the
+	 * offending token; message() builds the familiar error text only when asked.
+	 * The offending text is kept inline, so recording an error never allocates.
 	 */
-	class Argument
+	class ParseError
 	{
 	public:
-		/**
-		 * @brief Enumerates supported argument types.
-		 */
-		enum class ArgType { INT, FLOAT, STRING, BOOL, AUTO };
-
-	private:
-		std::string name_;
-		std::vector<std::string> aliases_;
-		std::string help_;
-		bool required_ = false;
-		std::variant<int, float, std::string, bool> default_value_;
-		bool is_flag_ = false;
-		std::optional<int> min_value_;
-		std::optional<int> max_value_;
-		std::optional<std::string> env_var_;
-		std::vector<std::string> choices_;
-		ArgType type_ = ArgType::AUTO;
-		std::function<bool(const std::string&)> custom_validator_;
-		std::optional<std::string> custom_validator_error_;
-
-		static std::string normalize_name(std::string name)
+		enum class Code : uint8_t
 		{
-			if (name.starts_with("--")) return name.substr(2);
-			if (name.starts_with("-")) return name.substr(1);
-			return name;
-		}
+			NONE,
+			HELP_REQUESTED,
+			NOT_COMPILED,
+			UNRECOGNIZED_ARGUMENT,
+			AMBIGUOUS_ARGUMENT,
+			MISSING_VALUE,
+			TOO_FEW_VALUES,
+			MISSING_REQUIRED,
+			MISSING_INTEGER,
+			INVALID_INTEGER,
+			INVALID_FLOAT,
+			INVALID_DURATION,
+			INVALID_SIZE,
+			BELOW_MINIMUM,
+			ABOVE_MAXIMUM,
+			INVALID_CHOICE,
+			VALIDATION_FAILED,
+			UNKNOWN_SUBCOMMAND,
+			UNREADABLE_FILE,
+			UNREADABLE_STREAM,
+			UNREADABLE_RESPONSE_FILE,
+			RESPONSE_FILES_TOO_DEEP,
+			OTHER
+		};
 
-	public:
 		/**
-		 * @brief Constructs an Argument with a given name.
-		 * @param name The name of the argument (e.g., "input", "verbose").
+		 * @brief Marks an error that is not tied to an argument or a token.
 		 */
-		Argument(std::string name) : name_(std::move(name)) {}
+		static constexpr size_t npos = static_cast<size_t>(-1);
 
 		/**
-		 * @brief Sets the help message shown in the generated help text.
-		 * @param text Help description.
-		 * @return Reference to the current Argument instance.
+		 * @brief The longest text() kept; longer text is cut to end in "...".
 		 */
-		Argument& help(std::string text) { help_ = std::move(text); return *this; }
+		static constexpr size_t max_text = 255;
 
-		/**
-		 * @brief Marks the argument as required.
-		 * @param req Set to true if the argument is required (default: true).
-		 * @return Reference to the current Argument instance.
-		 */
-		Argument& required(bool req = true) { required_ = req; return *this; }
+		ParseError() = default;
 
-		/**
-		 * @brief Adds an alias (short name) for the argument.
-		 * @param alias The alias (e.g., "v" for verbose).
-		 * @return Reference to the current Argument instance.
-		 * @throws ArgumentError if alias is empty or duplicates the name.
-		 */
-		Argument& add_alias(std::string alias)
+		ParseError(Code code, size_t argument, size_t token, std::string_view text, const ArgumentParser* parser = nullptr)
+			: code_(code), argument_(argument), token_(token), parser_(parser)
 		{
-			alias = normalize_name(std::move(alias));
-			if (alias.empty() || alias == name_) {
-				throw ArgumentError("Invalid alias");
-			}
-			aliases_.push_back(std::move(alias));
-			return *this;
+			set_text(text);
 		}
 
-
-		bool is_required() const
+		/**
+		 * @brief An OTHER error for an exception a parse caught, e.g. from a custom validator.
+		 * @param error The caught exception; message() returns its what() in full.
+		 * @param thrown The same exception, from std::current_exception().
+		 */
+		ParseError(const std::exception& error, std::exception_ptr thrown, size_t argument = npos, const ArgumentParser* parser = nullptr)
+			: code_(Code::OTHER), argument_(argument), parser_(parser), thrown_(std::move(thrown))
 		{
-			return required_;
+			set_text(error.what());
 		}
 
-		const std::string& name() const
+		Code code() const
 		{
-			return name_;
+			return code_;
 		}
 
-		const std::vector<std::string>& aliases() const
+		/**
+		 * @brief Index of the argument involved in ArgumentParser::arguments(), or npos.
+		 */
+		size_t argument_index() const
 		{
-			return aliases_;
+			return argument_;
 		}
 
-		const std::string& help() const
+		/**
+		 * @brief Position of the offending token, or npos.
+		 *
+		 * Counts the tokens after the program name, with response files expanded,
+		 * so for a plain command line the token is `argv[token_position() + 1]`.
+		 */
+		size_t token_position() const
 		{
-			return help_;
+			return token_;
 		}
 
-		const ArgType type() const
+		/**
+		 * @brief The offending text: the token, value, list element or file path, cut to max_text bytes.
+		 */
+		std::string_view text() const
 		{
-			return type_;
+			return { text_, text_size_ };
 		}
 
-		bool is_flag() const
+		/**
+		 * @brief The parser the argument index refers to, e.g. a subcommand's.
+		 *
+		 * It stays valid as long as the top-level parser that produced this error.
+		 */
+		const ArgumentParser* parser() const
 		{
-			return is_flag_;
+			return parser_;
 		}
 
-		const auto& default_value() const
-		{
-			return default_value_;
-		}
+		/**
+		 * @brief The error text, as ArgumentError would carry it; needs parser() to be alive.
+		 */
+		std::string message() const;
 
-		const std::vector<std::string>& choices() const
-		{
-			return choices_;
-		}
+	private:
+		Code code_ = Code::NONE;
+		uint8_t text_size_ = 0;
+		size_t argument_ = npos;
+		size_t token_ = npos;
+		const ArgumentParser* parser_ = nullptr;
+		std::exception_ptr thrown_;
+		char text_[max_text];
 
-		std::optional<std::string> get_env_value() const
+		void set_text(std::string_view text)
 		{
-			if (!env_var_) return std::nullopt;
-			const char* env_value = std::getenv(env_var_->c_str());
-			if (env_value) {
-				std::cout << "Found env value: " << env_value << std::endl;
-				return std::string(env_value);
+			if (text.size() <= max_text) {
+				if (!text.empty()) std::memcpy(text_, text.data(), text.size());
+				text_size_ = static_cast<uint8_t>(text.size());
+				return;
 			}
-			std::cout << "Environment variable " << *env_var_ << " not found!" << std::endl;
-			return std::nullopt;
+			// Cut before a UTF-8 continuation byte so the text stays valid.
+			size_t keep = max_text - 3;
+			while (keep > 0 && (static_cast<unsigned char>(text[keep]) & 0xC0) == 0x80) --keep;
+			std::memcpy(text_, text.data(), keep);
+			std::memcpy(text_ + keep, "...", 3);
+			text_size_ = static_cast<uint8_t>(keep + 3);
 		}
+	};
 
-		/**
-		 * @brief Sets a default value for the argument.
-		 * @tparam T Type of the value (int, float, string, bool).
-		 * @param val The default value.
-		 * @return Reference to the current Argument instance.
-		 */
-		template<typename T>
-		Argument& default_value(T val)
-		{
-			default_value_ = val;
-			return *this;
-		}
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+	template<typename T, typename E>
+	using expected = std::expected<T, E>;
 
-		/**
-		 * @brief Treats this argument as a flag (boolean switch).
-		 * @param set Whether to enable flag behavior (default: true).
-		 * @return Reference to the current Argument instance.
-		 */
-		Argument& flag(bool set = true)
+	template<typename E>
+	using unexpected = std::unexpected<E>;
+#else
+	/**
+	 * @brief Stand-in for std::unexpected on standard libraries without <expected>.
+	 */
+	template<typename E>
+	class unexpected
+	{
+		E error_;
+
+	public:
+		explicit unexpected(E error) : error_(std::move(error)) {}
+
+		const E& error() const& { return error_; }
+		E& error() & { return error_; }
+		E&& error() && { return std::move(error_); }
+	};
+
+	/**
+	 * @brief Thrown by expected::value() when it holds an error.
+	 */
+	class bad_expected_access : public std::exception
+	{
+	public:
+		const char* what() const noexcept override
 		{
-			is_flag_ = set;
-			if (set) default_value_ = false;
-			return *this;
+			return "bad access to expected without value";
 		}
+	};
 
-		/**
-		 * @brief Sets the minimum value (only applies to int type).
-		 * @param val The minimum allowed value.
-		 * @return Reference to the current Argument instance.
-		 */
-		Argument& min_value(int val)
+	/**
+	 * @brief Minimal std::expected for standard libraries without <expected>.
+	 */
+	template<typename T, typename E>
+	class expected
+	{
+		std::variant<T, E> storage_;
+
+	public:
+		expected(T value) : storage_(std::in_place_index<0>, std::move(value)) {}
+		expected(unexpected<E> error) : storage_(std::in_place_index<1>, std::move(error).error()) {}
+
+		bool has_value() const noexcept { return storage_.index() == 0; }
+		explicit operator bool() const noexcept { return has_value(); }
+
+		T& value() &
 		{
-			min_value_ = val;
-			return *this;
+			if (!has_value()) throw bad_expected_access();
+			return *std::get_if<0>(&storage_);
 		}
 
-		/**
-		 * @brief Sets the maximum value (only applies to int type).
-		 * @param val The maximum allowed value.
-		 * @return Reference to the current Argument instance.
-		 */
-		Argument& max_value(int val)
+		const T& value() const&
 		{
-			max_value_ = val;
-			return *this;
+			if (!has_value()) throw bad_expected_access();
+			return *std::get_if<0>(&storage_);
 		}
 
-		/**
-		 * @brief Sets an environment variable to use as a fallback value.
-		 * @param var_name Name of the environment variable.
-		 * @return Reference to the current Argument instance.
-		 */
-		Argument& env(const std::string& var_name)
+		T&& value() &&
 		{
-			env_var_ = var_name;
-			return *this;
+			if (!has_value()) throw bad_expected_access();
+			return std::move(*std::get_if<0>(&storage_));
 		}
 
+		T& operator*() & { return *std::get_if<0>(&storage_); }
+		const T& operator*() const& { return *std::get_if<0>(&storage_); }
+		T&& operator*() && { return std::move(*std::get_if<0>(&storage_)); }
+		T* operator->() { return std::get_if<0>(&storage_); }
+		const T* operator->() const { return std::get_if<0>(&storage_); }
+
+		E& error() & { return *std::get_if<1>(&storage_); }
+		const E& error() const& { return *std::get_if<1>(&storage_); }
+		E&& error() && { return std::move(*std::get_if<1>(&storage_)); }
+	};
+#endif
+
+	namespace detail
+	{
 		/**
-		 * @brief Restricts acceptable values to a list of choices.
-		 * @param options A list of valid string options.
-		 * @return Reference to the current Argument instance.
+		 * @brief A single command-line token viewed in place inside argv.
 		 */
-		Argument& choices(std::vector<std::string> options)
+		struct Token
 		{
-			choices_ = std::move(options);
-			return *this;
-		}
+			enum class Kind { LONG, SHORT, VALUE };
+
+			Kind kind;
+			std::string_view text;
+			std::string_view name;
+
+			bool is_help() const
+			{
+				return text == "--help" || text == "-h";
+			}
+		};
 
 		/**
-		 * @brief Specifies that the argument expects an integer value.
-		 * @return Reference to the current Argument instance.
+		 * @brief Classifies one raw token without copying it.
 		 */
-		Argument& type_int()
+		constexpr Token classify(std::string_view text)
 		{
-			return set_type<int>(ArgType::INT, 0);
+			if (text.starts_with("--")) return { Token::Kind::LONG, text, text.substr(2) };
+			if (text.starts_with("-")) return { Token::Kind::SHORT, text, text.substr(1) };
+			return { Token::Kind::VALUE, text, text };
 		}
 
 		/**
-		 * @brief Specifies that the argument expects a float value.
-		 * @return Reference to the current Argument instance.
+		 * @brief Whether text starts like a number, e.g. "5" or ".5,2"; an option so named would read as a negative value.
 		 */
-		Argument& type_float()
+		constexpr bool starts_number(std::string_view text)
 		{
-			return set_type<float>(ArgType::FLOAT, 0.0f);
+			auto digit = [](char c) { return c >= '0' && c <= '9'; };
+			if (text.empty()) return false;
+			return digit(text[0]) || (text[0] == '.' && text.size() > 1 && digit(text[1]));
 		}
 
 		/**
-		 * @brief Specifies that the argument expects a string value.
-		 * @return Reference to the current Argument instance.
+		 * @brief Whether a token that starts with '-' reads as a negative number, e.g. "-5" or "-.5,2".
 		 */
-		Argument& type_string()
+		constexpr bool is_negative_number(std::string_view text)
 		{
-			return set_type<std::string>(ArgType::STRING, std::string());
+			return text.size() >= 2 && text[0] == '-' && starts_number(text.substr(1));
 		}
 
 		/**
-		 * @brief Specifies that the argument expects a boolean value.
-		 * @return Reference to the current Argument instance.
+		 * @brief Single-pass tokenizer over argv that never copies a token.
+		 *
+		 * Classifies each entry as a long option (`--name`), a short option (`-n`)
+		 * or a plain value. Option names are views with the dashes removed.
 		 */
-		Argument& type_bool()
+		class Tokenizer
 		{
-			return set_type<bool>(ArgType::BOOL, false);
-		}
+			int argc_;
+			const char* const* argv_;
+			int pos_ = 1;
 
-		template<typename T>
-		Argument& set_type(ArgType arg_type, T default_val)
-		{
-			type_ = arg_type;
-			if (std::holds_alternative<T>(default_value_)) return *this;
-			default_value_ = default_val;
-			return *this;
-		}
+		public:
+			Tokenizer(int argc, const char* const* argv) : argc_(argc), argv_(argv) {}
 
-		/**
-		 * @brief Adds a custom validation function.
-		 * @param validate_fn A function that returns true if valid.
-		 * @param error_message Message to show if validation fails.
-		 * @return Reference to the current Argument instance.
-		 */
-		Argument& custom_validation(std::function<bool(const std::string&)> validate_fn, const std::string& error_message)
-		{
-			custom_validator_ = std::move(validate_fn);
-			custom_validator_error_ = error_message;
-			return *this;
-		}
+			bool done() const
+			{
+				return pos_ >= argc_;
+			}
+
+			/**
+			 * @brief Checks whether the next token can be consumed as an option value.
+			 * @param negative Also accept a token that reads as a negative number.
+			 * @return True if a token follows and it does not start with '-', or is such a number.
+			 */
+			bool next_is_value(bool negative = false) const
+			{
+				return !done() && (argv_[pos_][0] != '-' || (negative && is_negative_number(argv_[pos_])));
+			}
+
+			Token next()
+			{
+				return classify(argv_[pos_++]);
+			}
+		};
 
 		/**
-		 * @brief Validates the provided string value.
-		 * @param value_str The string to validate.
-		 * @throws ArgumentError if validation fails.
+		 * @brief Read-only view of a whole file, memory-mapped where the platform allows.
+		 *
+		 * The mapping is private and writable, so in-place unescaping only copies
+		 * the pages it actually touches and never modifies the file on disk.
+		 * Pipes, FIFOs, terminals and files that report a size of 0, such as
+		 * `/dev/stdin` or procfs entries, are read into an owned buffer instead.
 		 */
-		void validate(const std::string& value_str) const
+		class MappedFile
 		{
-			if (type_ == ArgType::INT) {
-				if (value_str.empty()) throw ArgumentError("Missing integer value");
-				try {
-					int value = std::stoi(value_str);
-					if (min_value_ && value < *min_value_) {
-						throw ArgumentError("Value must be > " + std::to_string(*min_value_));
-					}
-					if (max_value_ && value > *max_value_) {
-						throw ArgumentError("Value must be < " + std::to_string(*max_value_));
-					}
+			char* data_ = nullptr;
+			size_t size_ = 0;
+			bool mapped_ = false;
+
+		public:
+			MappedFile() = default;
+
+			/**
+			 * @brief Maps (or reads) a file.
+			 * @param path Path of the file.
+			 * @return The contents, or std::nullopt if the file cannot be read.
+			 */
+			static std::optional<MappedFile> open(const std::string& path)
+			{
+				MappedFile file;
+#if ARGPARSE_HAS_MMAP
+				const int fd = ::open(path.c_str(), O_RDONLY);
+				if (fd < 0) return std::nullopt;
+				struct stat info;
+				if (::fstat(fd, &info) != 0) {
+					::close(fd);
+					return std::nullopt;
 				}
-				catch (...) {
-					throw ArgumentError("Invalid integer value: " + value_str);
+				void* data = MAP_FAILED;
+				if (S_ISREG(info.st_mode) && info.st_size > 0) {
+					data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
 				}
+				if (data != MAP_FAILED) {
+					file.data_ = static_cast<char*>(data);
+					file.size_ = static_cast<size_t>(info.st_size);
+					file.mapped_ = true;
+				}
+				else if (!file.read_fd(fd)) {
+					::close(fd);
+					return std::nullopt;
+				}
+				::close(fd);
+#else
+				std::ifstream in(path, std::ios::binary);
+				if (!in) return std::nullopt;
+				if (!file.read_stream(in)) return std::nullopt;
+#endif
+				return file;
+			}
+
+			/**
+			 * @brief Reads a whole stream into an owned buffer.
+			 * @param in The stream.
+			 * @return The contents, or std::nullopt if reading fails.
+			 */
+			static std::optional<MappedFile> read(std::istream& in)
+			{
+				MappedFile file;
+				if (!file.read_stream(in)) return std::nullopt;
+				return file;
+			}
+
+			/**
+			 * @brief Copies text into an owned buffer.
+			 */
+			static MappedFile copy(std::string_view text)
+			{
+				MappedFile file;
+				file.size_ = text.size();
+				file.data_ = new char[file.size_ ? file.size_ : 1];
+				if (!text.empty()) std::memcpy(file.data_, text.data(), text.size());
+				return file;
+			}
+
+			MappedFile(MappedFile&& other) noexcept
+				: data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+				mapped_(std::exchange(other.mapped_, false)) {}
+
+			MappedFile& operator=(MappedFile&& other) noexcept
+			{
+				std::swap(data_, other.data_);
+				std::swap(size_, other.size_);
+				std::swap(mapped_, other.mapped_);
+				return *this;
 			}
-			else if (!choices_.empty()) {
-				if (std::find(choices_.begin(), choices_.end(), value_str) == choices_.end()) {
-					throw ArgumentError("Invalid choice. Options: " + join_strings(choices_, ", "));
+
+			~MappedFile()
+			{
+#if ARGPARSE_HAS_MMAP
+				if (mapped_) {
+					::munmap(data_, size_);
+					return;
 				}
+#endif
+				delete[] data_;
 			}
-				
-			if (custom_validator_ && !custom_validator_(value_str)) {
-				throw ArgumentError(custom_validator_error_.value_or("Validation failed."));
+
+			char* begin() const
+			{
+				return data_;
 			}
-		}
 
-		// Utility function:
+			char* end() const
+			{
+				return data_ + size_;
+			}
+
+		private:
+#if ARGPARSE_HAS_MMAP
+			bool read_fd(int fd)
+			{
+				std::string contents;
+				char chunk[65536];
+				for (;;) {
+					const ssize_t count = ::read(fd, chunk, sizeof(chunk));
+					if (count == 0) break;
+					if (count < 0) {
+						if (errno == EINTR) continue;
+						return false;
+					}
+					contents.append(chunk, static_cast<size_t>(count));
+				}
+				size_ = contents.size();
+				data_ = new char[size_ ? size_ : 1];
+				std::memcpy(data_, contents.data(), size_);
+				return true;
+			}
+#endif
+
+			bool read_stream(std::istream& in)
+			{
+				std::string contents{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+				if (in.bad()) return false;
+				size_ = contents.size();
+				data_ = new char[size_ ? size_ : 1];
+				std::memcpy(data_, contents.data(), size_);
+				return true;
+			}
+		};
+
 		/**
-		 * @brief Joins a vector of strings with a delimiter.
-		 * @param vec The vector of strings.
-		 * @param delim The delimiter string.
-		 * @return A concatenated string.
+		 * @brief Splits the next whitespace-separated token out of a mutable buffer.
+		 *
+		 * Understands '...' and "..." quoting and backslash escapes. Tokens are
+		 * unescaped in place, and bytes are only written when a quote or escape
+		 * was removed, so plain tokens are views straight into the buffer.
+		 *
+		 * @param pos Cursor into the buffer, advanced past the token.
+		 * @param end End of the buffer.
+		 * @return The token, or std::nullopt at the end of the buffer.
 		 */
-		static std::string join_strings(const std::vector<std::string>& vec, const std::string& delim)
+		inline std::optional<std::string_view> next_text_token(char*& pos, char* end)
 		{
-			std::string result;
-			for (size_t i = 0; i < vec.size(); ++i) {
-				if (i != 0) result += delim;
-				result += vec[i];
+			auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; };
+			while (pos < end && is_space(*pos)) ++pos;
+			if (pos == end) return std::nullopt;
+
+			char* const start = pos;
+			char* out = pos;
+			char quote = 0;
+			while (pos < end) {
+				char c = *pos;
+				if (!quote && is_space(c)) break;
+				if (quote ? c == quote : (c == '\'' || c == '"')) {
+					quote = quote ? 0 : c;
+					++pos;
+					continue;
+				}
+				if (c == '\\' && quote != '\'' && pos + 1 < end) c = *++pos;
+				if (out != pos) *out = c;
+				++out;
+				++pos;
 			}
-			return result;
+			return std::string_view(start, static_cast<size_t>(out - start));
 		}
-	};
 
-	class ParsedArgs
-	{
-		std::map<std::string, std::variant<int, float, std::string, bool>> values_;
-	public:
-		template<typename T>
-		T get(const std::string& name) const
+		/**
+		 * @brief Token source that feeds the parser from argv, a token list or text
+		 *        buffers, expanding `@file` response files on the fly.
+		 *
+		 * Tokens from every source are string_views; nothing is copied into a
+		 * temporary argv. Plain argv parsing allocates nothing here; nested
+		 * sources are only tracked once a response file is opened.
+		 */
+		class TokenStream
 		{
-			std::string key = name.starts_with("--") ? name.substr(2) :
-				name.starts_with("-") ? name.substr(1) : name;
-			return std::get<T>(values_.at(key));
-		}
+			struct Source
+			{
+				const char* const* argv = nullptr;
+				const std::string_view* views = nullptr;
+				size_t size = 0;
+				size_t pos = 0;
+				char* text = nullptr;
+				char* text_end = nullptr;
 
-		friend class ArgumentParser;
-	};
+				std::optional<std::string_view> next()
+				{
+					if (text) return next_text_token(text, text_end);
+					if (pos >= size) return std::nullopt;
+					return argv ? std::string_view(argv[pos++]) : views[pos++];
+				}
+			};
 
-	/**
-	 * @brief Command-line argument parser.
-	 *
-	 * This class allows you to define and parse command-line arguments for your application.
-	 *
-	 * Example usage:
-	 * @code
-	 * argparse::ArgumentParser parser("myapp");
-	 * parser.add_argument("mode")
-	 *       .help("Mode of operation")
-	 *       .choices({ "debug", "release" });
-	 *
-	 * auto args = parser.parse_args(argc, argv);
-	 * std::string mode = args.get<std::string>("mode");
-	 * @endcode
-	 */
-	class ArgumentParser
-	{
-		bool auto_help_ = true;
-		std::string prog_name_;
-		std::vector<Argument> args_;
-		std::unordered_map<std::string, size_t> arg_index_;
+			static constexpr size_t max_depth = 16;
 
-		void build_lookup()
-		{
-			arg_index_.clear();
-			for (size_t i = 0; i < args_.size(); ++i) {
-				const auto& arg = args_[i];
-				arg_index_[arg.name()] = i;
-				for (const auto& alias : arg.aliases()) {
-					if (arg_index_.count(alias)) {
-						throw ArgumentError("Duplicate alias: -" + alias);
+			bool expand_files_;
+			Source base_;
+			std::vector<Source> nested_;
+			std::vector<MappedFile> files_;
+			std::optional<std::string_view> lookahead_;
+			std::optional<ParseError> error_;
+			size_t position_ = 0;
+
+			std::optional<std::string_view> pull()
+			{
+				while (!error_) {
+					Source& source = nested_.empty() ? base_ : nested_.back();
+					auto raw = source.next();
+					if (!raw) {
+						if (nested_.empty()) return std::nullopt;
+						nested_.pop_back();
+						continue;
 					}
-					arg_index_[alias] = i;
+					if (expand_files_ && raw->size() > 1 && raw->front() == '@') {
+						open(std::string(raw->substr(1)));
+						continue;
+					}
+					return raw;
 				}
+				return std::nullopt;
 			}
-		}
 
-		std::string format_help_line(const Argument& arg) const
-		{
-			std::ostringstream oss;
-			oss << "--" << arg.name();
-			for (const auto& alias : arg.aliases()) {
-				oss << ", -" << alias;
+			void open(const std::string& path)
+			{
+				if (nested_.size() >= max_depth) {
+					error_ = ParseError(ParseError::Code::RESPONSE_FILES_TOO_DEEP, ParseError::npos, position_, path);
+					return;
+				}
+				auto file = MappedFile::open(path);
+				if (!file) {
+					error_ = ParseError(ParseError::Code::UNREADABLE_RESPONSE_FILE, ParseError::npos, position_, path);
+					return;
+				}
+				push_text(file->begin(), file->end());
+				files_.push_back(std::move(*file));
+			}
+
+			void push_text(char* begin, char* end)
+			{
+				Source source;
+				source.text = begin;
+				source.text_end = end;
+				nested_.push_back(source);
 			}
-			oss << "\t" << arg.help();
 
-			if (std::holds_alternative<std::string>(arg.default_value())) {
-				oss << " [default: " << std::get<std::string>(arg.default_value()) << "]";
+		public:
+			explicit TokenStream(bool expand_files) : expand_files_(expand_files) {}
+
+			TokenStream(const TokenStream&) = delete;
+			TokenStream& operator=(const TokenStream&) = delete;
+
+			void set_argv(size_t count, const char* const* argv)
+			{
+				base_.argv = argv;
+				base_.size = count;
 			}
-			else if (std::holds_alternative<int>(arg.default_value())) {
-				oss << " [default: " << std::get<int>(arg.default_value()) << "]";
+
+			void set_views(size_t count, const std::string_view* views)
+			{
+				base_.views = views;
+				base_.size = count;
 			}
-			else if (std::holds_alternative<float>(arg.default_value())) {
-				oss << " [default: " << std::get<float>(arg.default_value()) << "]";
+
+			/**
+			 * @brief Tokenizes a whole buffer in place; the stream keeps it alive.
+			 */
+			void set_file(MappedFile file)
+			{
+				push_text(file.begin(), file.end());
+				files_.push_back(std::move(file));
 			}
-			else if (std::holds_alternative<bool>(arg.default_value())) {
-				oss << " [default: " << std::get<bool>(arg.default_value()) << "]";
+
+			bool done()
+			{
+				if (!lookahead_) lookahead_ = pull();
+				return !lookahead_;
 			}
 
-			if (!arg.choices().empty()) {
-				oss << " (choices: " << Argument::join_strings(arg.choices(), ", ") << ")";
+			/**
+			 * @brief Checks whether the next token can be consumed as an option value.
+			 * @param negative Also accept a token that reads as a negative number.
+			 */
+			bool next_is_value(bool negative = false)
+			{
+				if (done()) return false;
+				return lookahead_->empty() || lookahead_->front() != '-' || (negative && is_negative_number(*lookahead_));
 			}
 
-			if (arg.is_required()) {
-				oss << " (required)";
+			Token next()
+			{
+				done();
+				const std::string_view text = *lookahead_;
+				lookahead_.reset();
+				++position_;
+				return classify(text);
+			}
+
+			/**
+			 * @brief Position of the token the last next() returned.
+			 */
+			size_t position() const
+			{
+				return position_ - 1;
+			}
+
+			/**
+			 * @brief A response-file error that ended the stream early, if any.
+			 */
+			const std::optional<ParseError>& error() const
+			{
+				return error_;
+			}
+		};
+
+		/**
+		 * @brief Marks a provided flag, which carries no value of its own.
+		 *
+		 * Any non-null view counts as "provided"; a default-constructed view does not.
+		 */
+		inline constexpr std::string_view flag_marker{ "" };
+
+		/**
+		 * @brief Transparent hasher so string-keyed maps can be probed with
+		 *        `std::string_view` or `const char*` without allocating a key.
+		 */
+		struct StringHash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::string_view text) const noexcept
+			{
+				return std::hash<std::string_view>{}(text);
 			}
+		};
+
+		template<typename T>
+		using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
 
-			return oss.str();
+		/**
+		 * @brief Removes a leading "--" or "-" from an argument name.
+		 * @param name The name as written by the user.
+		 * @return A view of the bare name.
+		 */
+		constexpr std::string_view strip_dashes(std::string_view name)
+		{
+			if (name.starts_with("--")) return name.substr(2);
+			if (name.starts_with("-")) return name.substr(1);
+			return name;
 		}
 
-	public:
 		/**
-		 * @brief Create a new ArgumentParser with the given program name.
-		 * @param prog_name The name of the program, typically argv[0].
+		 * @brief Parses a whole token as a number without throwing.
+		 * @tparam T An arithmetic type supported by std::from_chars.
+		 * @param text The token; a single leading '+' is accepted.
+		 * @return The value, or std::nullopt if the token is not entirely a valid T.
 		 */
-		explicit ArgumentParser(std::string prog_name) : prog_name_(std::move(prog_name)) {}
+		template<typename T>
+		std::optional<T> parse_number(std::string_view text)
+		{
+			if (text.size() > 1 && text[0] == '+' && text[1] != '-') text.remove_prefix(1);
+
+			T value{};
+			const char* end = text.data() + text.size();
+			auto [ptr, ec] = std::from_chars(text.data(), end, value);
+			if (ec != std::errc() || ptr != end) return std::nullopt;
+			return value;
+		}
 
 		/**
-		 * @brief Enable or disable automatic help display.
-		 * @param enable If true, displays help if no arguments or --help/-h is provided.
-		 * @return Reference to this parser.
+		 * @brief Cheap pre-check so obvious non-numbers skip numeric parsing entirely.
 		 */
-		ArgumentParser& auto_help(bool enable)
+		constexpr bool may_be_number(std::string_view text)
 		{
-			auto_help_ = enable;
-			return *this;
+			if (text.empty()) return false;
+			const char c = text[0];
+			return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
 		}
 
+#if ARGPARSE_SIMD_WIDTH
 		/**
-		 * @brief Add a new command-line argument.
+		 * @brief Bytes covered by one delimiter_mask() and the mask bits each byte owns.
+		 */
+		constexpr size_t simd_width = ARGPARSE_SIMD_WIDTH;
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+		constexpr int simd_bits_per_byte = 4;
+#else
+		constexpr int simd_bits_per_byte = 1;
+#endif
+
+		/**
+		 * @brief Bitmask of the bytes equal to `c` among the simd_width bytes at `p`.
 		 *
-		 * Creates a new `Argument` object and returns a reference to it so you can chain configuration calls.
+		 * Each matching byte sets exactly one bit, at position byte * simd_bits_per_byte.
+		 */
+		inline uint64_t delimiter_mask(const char* p, char c)
+		{
+#if defined(__AVX2__)
+			const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c))));
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+			const uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p)), vdupq_n_u8(static_cast<uint8_t>(c)));
+			// Narrowing shift packs the 16 compare bytes into one nibble each.
+			const uint8x8_t packed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+			return vget_lane_u64(vreinterpret_u64_u8(packed), 0) & 0x8888888888888888ull;
+#else
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(c))));
+#endif
+		}
+#endif
+
+		/**
+		 * @brief Calls `fn` for each piece of `token` split at `delimiter` (no split if 0).
 		 *
-		 * @param name The name of the argument (e.g., "input" or "--file").
-		 * @return Reference to the newly created Argument object.
+		 * Delimiters are located a vector at a time, so long lists cost one
+		 * compare per simd_width bytes rather than one per byte.
+		 *
+		 * @param fn Returns false to stop early.
+		 * @return False if `fn` stopped the walk.
 		 */
-		Argument& add_argument(std::string name)
+		template<typename Fn>
+		bool for_each_piece(std::string_view token, char delimiter, Fn&& fn)
 		{
-			args_.emplace_back(std::move(name));
-			return args_.back();
+			if (!delimiter) return fn(token);
+			const char* data = token.data();
+			const size_t size = token.size();
+			size_t start = 0;
+			size_t i = 0;
+#if ARGPARSE_SIMD_WIDTH
+			for (; i + simd_width <= size; i += simd_width) {
+				for (uint64_t mask = delimiter_mask(data + i, delimiter); mask; mask &= mask - 1) {
+					const size_t at = i + static_cast<size_t>(std::countr_zero(mask) / simd_bits_per_byte);
+					if (!fn(std::string_view(data + start, at - start))) [[unlikely]] return false;
+					start = at + 1;
+				}
+			}
+#endif
+			for (; i < size; ++i) {
+				if (data[i] == delimiter) {
+					if (!fn(std::string_view(data + start, i - start))) [[unlikely]] return false;
+					start = i + 1;
+				}
+			}
+			return fn(std::string_view(data + start, size - start));
 		}
 
 		/**
-		 * @brief Get a formatted help string showing all arguments and their descriptions.
-		 * @return The help text as a string.
+		 * @brief Number of bytes equal to `c` in `text`.
 		 */
-		std::string help() const
+		inline size_t count_byte(std::string_view text, char c)
 		{
-			std::string help_text = "Usage: " + prog_name_ + " [OPTIONS]\n\nOptions:\n";
-			for (const auto& arg : args_) {
-				help_text += "  " + format_help_line(arg) + "\n";
+			size_t count = 0;
+			size_t i = 0;
+#if ARGPARSE_SIMD_WIDTH
+			for (; i + simd_width <= text.size(); i += simd_width) {
+				count += static_cast<size_t>(std::popcount(delimiter_mask(text.data() + i, c)));
 			}
-			return help_text;
+#endif
+			for (; i < text.size(); ++i) count += text[i] == c;
+			return count;
 		}
 
 		/**
-		 * @brief Parse the command-line arguments.
-		 *
-		 * Parses `argc` and `argv`, applying validations, default values, environment fallbacks, etc.
-		 * If `--help` or no arguments are passed and `auto_help` is enabled, it prints help and exits.
-		 *
-		 * @param argc Argument count (from `main`).
-		 * @param argv Argument values (from `main`).
-		 * @return A ParsedArgs object to retrieve argument values by name.
-		 * @throws ArgumentError If any validation fails or required argument is missing.
+		 * @brief Parses up to eight ASCII digits at once with SWAR arithmetic.
+		 * @param p The digits.
+		 * @param len Number of digits, 1 to 8.
+		 * @param limit End of the readable memory around `p`; a full 8-byte load is used when it allows.
+		 * @return The value, or std::nullopt if any byte is not a digit.
 		 */
-		ParsedArgs parse_args(int argc, char** argv)
+		inline std::optional<uint32_t> parse_digits8(const char* p, size_t len, const char* limit)
 		{
-			build_lookup();
-			std::unordered_map<std::string, std::string> provided_args;
-			ParsedArgs result;
+			constexpr uint64_t zeros = 0x3030303030303030ull;
+			constexpr uint64_t high_nibbles = 0xF0F0F0F0F0F0F0F0ull;
 
-			if (auto_help_ && argc == 1) {
-				std::cout << help();
-				std::exit(0);
+			uint64_t v;
+			if (limit - p >= 8) {
+				std::memcpy(&v, p, 8);
 			}
 			else {
-				for (int i = 1; i < argc; ++i) {
-					if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
-						std::cout << help();
-						std::exit(0);
-					}
-				}
+				char buffer[8] = { '0', '0', '0', '0', '0', '0', '0', '0' };
+				std::memcpy(buffer, p, len);
+				std::memcpy(&v, buffer, 8);
 			}
-			
-			for (int i = 1; i < argc; ++i) {
-				std::string arg = argv[i];
-				std::string name, value;
+			// Bytes past the piece read as '0' so the digit test only sees the piece.
+			const uint64_t keep = len == 8 ? ~0ull : (1ull << (len * 8)) - 1;
+			v = (v & keep) | (zeros & ~keep);
+			if ((v & high_nibbles) != zeros || ((v + 0x0606060606060606ull) & high_nibbles) != zeros) {
+				return std::nullopt;
+			}
+			// Shift the digits to the most significant end; the vacated bytes act as leading zeros.
+			v = (v - zeros) << ((8 - len) * 8);
+			v = v * 10 + (v >> 8);
+			v = ((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))
+				+ ((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))) >> 32;
+			return static_cast<uint32_t>(v);
+		}
 
-				if (arg.starts_with("--")) {
-					name = arg.substr(2);
-					if (!arg_index_.count(name)) {
-						throw ArgumentError("Unrecognized argument: --" + name);
-					}
-					if (i + 1 < argc && !std::string(argv[i + 1]).starts_with("-")) {
-						value = argv[++i];
-					}
-					else if (!arg_index_.count(name) || !args_[arg_index_.at(name)].is_flag()) {
-						throw ArgumentError("Missing value for --" + name);
-					}
+		/**
+		 * @brief parse_number<int> with a branch-light path for short decimal pieces.
+		 * @param text The piece to parse.
+		 * @param limit End of the readable memory after `text`, e.g. the end of the whole token.
+		 */
+		inline std::optional<int> parse_int(std::string_view text, const char* limit = nullptr)
+		{
+			if constexpr (std::endian::native == std::endian::little) {
+				const bool negative = !text.empty() && text[0] == '-';
+				const size_t sign = !text.empty() && (text[0] == '-' || text[0] == '+');
+				const size_t digits = text.size() - sign;
+				if (digits >= 1 && digits <= 8) {
+					const char* end = text.data() + text.size();
+					auto value = parse_digits8(text.data() + sign, digits, limit && limit > end ? limit : end);
+					if (!value) return std::nullopt;
+					return negative ? -static_cast<int>(*value) : static_cast<int>(*value);
 				}
-				else if (arg.starts_with("-")) {
-					name = arg.substr(1);
-					if (!arg_index_.count(name)) {
-						throw ArgumentError("Unrecognized argument: -" + name);
-					}
-					if (i + 1 < argc && !std::string(argv[i + 1]).starts_with("-")) {
-						value = argv[++i];
-					}
-					else if (!arg_index_.count(name) || !args_[arg_index_.at(name)].is_flag()) {
-						throw ArgumentError("Missing value for -" + name);
+			}
+			return parse_number<int>(text);
+		}
+
+		/**
+		 * @brief Parses one "<number><unit>" run at the front of `text` and scales it to the base unit.
+		 *
+		 * The whole part is scaled exactly in integer arithmetic. A fractional
+		 * part, as in "1.5", is rounded to the nearest base unit through double,
+		 * or with `exact` must scale to a whole number of base units.
+		 *
+		 * @param text Advanced past the number and its unit on success.
+		 * @param unit Maps the unit text (possibly empty) to its multiplier, or 0 if it is not a unit.
+		 * @param out Receives the scaled value.
+		 * @param exact Rejects a fraction that does not scale to a whole number, e.g. "1.5" bytes.
+		 * @return False if there is no number, the unit is unknown, the fraction is inexact, or the result overflows.
+		 */
+		template<typename Unit>
+		bool parse_scaled(std::string_view& text, Unit&& unit, uint64_t& out, bool exact = false)
+		{
+			size_t i = 0;
+			uint64_t whole = 0;
+			bool digits = false;
+			for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+				const uint64_t digit = static_cast<uint64_t>(text[i] - '0');
+				if (whole > (std::numeric_limits<uint64_t>::max() - digit) / 10) return false;
+				whole = whole * 10 + digit;
+				digits = true;
+			}
+			uint64_t fraction = 0;
+			uint64_t scale = 1;
+			bool truncated = false;
+			if (i < text.size() && text[i] == '.') {
+				// Digits past what a double can resolve are consumed but do not change the result.
+				for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+					if (scale < 1000000000000000000ull) {
+						fraction = fraction * 10 + static_cast<uint64_t>(text[i] - '0');
+						scale *= 10;
 					}
+					else if (text[i] != '0') truncated = true;
+					digits = true;
 				}
+			}
+			if (!digits) return false;
 
-				if (!name.empty() && arg_index_.count(name)) {
-					provided_args[args_[arg_index_.at(name)].name()] = std::move(value);
-				}
+			size_t end = i;
+			while (end < text.size() && !(text[end] >= '0' && text[end] <= '9') && text[end] != '.') ++end;
+			const uint64_t multiplier = unit(text.substr(i, end - i));
+			if (multiplier == 0) return false;
+			if (whole && multiplier > std::numeric_limits<uint64_t>::max() / whole) return false;
+
+			const uint64_t scaled = whole * multiplier;
+			uint64_t rest = 0;
+			if (exact) {
+				// fraction / scale reduces to n / d; it scales exactly only if d divides the multiplier.
+				if (truncated) return false;
+				const uint64_t common = std::gcd(fraction, scale);
+				const uint64_t d = scale / common;
+				if (multiplier % d != 0) return false;
+				rest = multiplier / d * (fraction / common);
+			}
+			else if (fraction) {
+				// Non-negative, so truncating after adding 0.5 rounds to nearest.
+				const double rounded = static_cast<double>(fraction) / static_cast<double>(scale) * static_cast<double>(multiplier) + 0.5;
+				if (rounded >= 18446744073709551616.0) return false;
+				rest = static_cast<uint64_t>(rounded);
+			}
+			if (rest > std::numeric_limits<uint64_t>::max() - scaled) return false;
+			out = scaled + rest;
+			text.remove_prefix(end);
+			return true;
+		}
+
+		/**
+		 * @brief Nanoseconds per duration unit: ns, us (or µs), ms, s, m, h, d.
+		 */
+		constexpr uint64_t duration_unit(std::string_view unit)
+		{
+			if (unit == "ns") return 1;
+			if (unit == "us" || unit == "\xC2\xB5s") return 1000;
+			if (unit == "ms") return 1000000;
+			if (unit == "s") return 1000000000;
+			if (unit == "m") return 60ull * 1000000000;
+			if (unit == "h") return 3600ull * 1000000000;
+			if (unit == "d") return 86400ull * 1000000000;
+			return 0;
+		}
+
+		/**
+		 * @brief Parses a duration such as "250ms", "1.5s" or "1h30m" into nanoseconds.
+		 *
+		 * Every number needs a unit except a bare "0"; a leading '-' negates the sum.
+		 *
+		 * @return The duration, or std::nullopt if it is malformed or does not fit in int64_t.
+		 */
+		inline std::optional<int64_t> parse_duration(std::string_view text)
+		{
+			const bool negative = !text.empty() && text[0] == '-';
+			if (!text.empty() && (text[0] == '-' || text[0] == '+')) text.remove_prefix(1);
+			if (text == "0") return 0;
+			if (text.empty()) return std::nullopt;
+
+			uint64_t total = 0;
+			while (!text.empty()) {
+				uint64_t part;
+				if (!parse_scaled(text, duration_unit, part)) return std::nullopt;
+				if (part > std::numeric_limits<uint64_t>::max() - total) return std::nullopt;
+				total += part;
 			}
+			if (total > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + negative) return std::nullopt;
+			return negative ? static_cast<int64_t>(0 - total) : static_cast<int64_t>(total);
+		}
 
-			for (const auto& arg : args_) {
-				const std::string& name = arg.name();
-				result.values_[name] = arg.default_value();
+		/**
+		 * @brief Bytes per size unit.
+		 *
+		 * A bare number or "B" is bytes; k (or K), M, G, T, P and E are powers of
+		 * 1000, optionally followed by "B"; "Ki", "Mi", ... and "KiB", "MiB", ...
+		 * are powers of 1024.
+		 */
+		constexpr uint64_t size_unit(std::string_view unit)
+		{
+			if (unit.empty() || unit == "B") return 1;
+			constexpr std::string_view prefixes = "KMGTPE";
+			const size_t power = prefixes.find(unit[0] == 'k' ? 'K' : unit[0]);
+			if (power == std::string_view::npos) return 0;
 
-				if (arg.is_flag()) {
-					result.values_[name] = true;
-				} else if (provided_args.count(name)) {
-					const std::string& value_str = provided_args.at(name);
-					arg.validate(value_str);
-					result.values_[name] = convert_value(value_str, arg.type());
-				}
-				else if (auto env_val = arg.get_env_value()) {
-					arg.validate(*env_val);
-					result.values_[name] = convert_value(*env_val, arg.type());
-				}
-				else if (arg.is_required()) {
-					throw ArgumentError("Missing required argument: --" + name);
+			const std::string_view rest = unit.substr(1);
+			uint64_t base;
+			if (rest.empty() || rest == "B") base = 1000;
+			else if (rest == "i" || rest == "iB") base = 1024;
+			else return 0;
+
+			uint64_t multiplier = 1;
+			for (size_t i = 0; i <= power; ++i) multiplier *= base;
+			return multiplier;
+		}
+
+		/**
+		 * @brief Parses a byte size such as "4096", "512KiB", "64GiB" or "1.5GB".
+		 *
+		 * A fraction must come to a whole number of bytes, so "1.5KiB" is accepted but "1.5" and "0.4" are not.
+		 *
+		 * @return The size in bytes, or std::nullopt if it is malformed or does not fit in uint64_t.
+		 */
+		inline std::optional<uint64_t> parse_size(std::string_view text)
+		{
+			if (!text.empty() && text[0] == '+') text.remove_prefix(1);
+			uint64_t bytes;
+			if (!parse_scaled(text, size_unit, bytes, true) || !text.empty()) return std::nullopt;
+			return bytes;
+		}
+
+		/**
+		 * @brief Formats nanoseconds with the largest unit that divides them exactly, e.g. "90s" or "250ms".
+		 */
+		inline std::string format_duration(int64_t ns)
+		{
+			constexpr std::pair<std::string_view, uint64_t> units[] = {
+				{ "d", duration_unit("d") }, { "h", duration_unit("h") }, { "m", duration_unit("m") },
+				{ "s", duration_unit("s") }, { "ms", duration_unit("ms") }, { "us", duration_unit("us") },
+			};
+			const uint64_t magnitude = ns < 0 ? 0 - static_cast<uint64_t>(ns) : static_cast<uint64_t>(ns);
+			std::string text = ns < 0 ? "-" : "";
+			if (magnitude == 0) return "0s";
+			for (const auto& [name, multiplier] : units) {
+				if (magnitude % multiplier == 0) return text + std::to_string(magnitude / multiplier) + std::string(name);
+			}
+			return text + std::to_string(magnitude) + "ns";
+		}
+
+		/**
+		 * @brief Formats a byte count with the exact unit giving the smallest number, e.g. "64GiB" or "1500kB".
+		 */
+		inline std::string format_size(uint64_t bytes)
+		{
+			constexpr std::string_view units[] = { "KiB", "MiB", "GiB", "TiB", "PiB", "EiB", "kB", "MB", "GB", "TB", "PB", "EB" };
+			std::string_view best = "B";
+			uint64_t best_count = bytes;
+			for (std::string_view unit : units) {
+				const uint64_t multiplier = size_unit(unit);
+				if (bytes && bytes % multiplier == 0 && bytes / multiplier < best_count) {
+					best = unit;
+					best_count = bytes / multiplier;
 				}
 			}
+			return std::to_string(best_count) + std::string(best);
+		}
+	}
 
-			return result;
+	namespace detail
+	{
+		using Value = std::variant<int, float, std::string, bool, int64_t, uint64_t, double>;
+
+		/**
+		 * @brief Element type of a list-valued argument.
+		 */
+		enum class ElementType : uint8_t { INT, FLOAT, STRING, BOOL, INT64, UINT64, DOUBLE };
+
+		template<typename T>
+		constexpr ElementType element_type_of()
+		{
+			if constexpr (std::is_same_v<T, int>) return ElementType::INT;
+			else if constexpr (std::is_same_v<T, float>) return ElementType::FLOAT;
+			else if constexpr (std::is_same_v<T, bool>) return ElementType::BOOL;
+			else if constexpr (std::is_same_v<T, int64_t>) return ElementType::INT64;
+			else if constexpr (std::is_same_v<T, uint64_t>) return ElementType::UINT64;
+			else if constexpr (std::is_same_v<T, double>) return ElementType::DOUBLE;
+			else {
+				static_assert(std::is_same_v<T, std::string_view>,
+					"List elements are int, float, bool, int64_t, uint64_t, double or std::string_view");
+				return ElementType::STRING;
+			}
 		}
 
-	private:
-		std::variant<int, float, std::string, bool> convert_value(const std::string& value_str, Argument::ArgType type)
+		/**
+		 * @brief A contiguous, typed array of list elements stored in a ParsedArgs block.
+		 */
+		struct ListView
 		{
-			try {
-				switch (type)
-				{
-					case Argument::ArgType::INT: return std::stoi(value_str);
-					case Argument::ArgType::FLOAT: return std::stof(value_str);
-					case Argument::ArgType::BOOL: return (value_str == "true" || value_str == "1");
-					case Argument::ArgType::STRING: return value_str;
-					case Argument::ArgType::AUTO: {
-						if (value_str == "true" || value_str == "false" ||
-							value_str == "1" || value_str == "0") {
-							return value_str == "true" || value_str == "1";
-						}
+			const void* data = nullptr;
+			uint32_t size = 0;
+			ElementType type = ElementType::STRING;
+		};
 
-						try {
-							size_t pos;
-							int i = std::stoi(value_str, &pos);
-							if (pos == value_str.size()) return i;
-						}
-						catch (...) {}
+		/**
+		 * @brief Non-owning form of Value; strings refer to the text they came from.
+		 *
+		 * The widest alternatives are two words, so every stored value costs
+		 * three words whatever its type; durations are int64_t nanoseconds and
+		 * sizes uint64_t bytes.
+		 */
+		using ValueView = std::variant<int, float, std::string_view, bool, ListView, int64_t, uint64_t, double>;
+		static_assert(sizeof(ValueView) <= 3 * sizeof(void*), "ValueView must stay three words");
 
-						try {
-							size_t pos;
-							float f = std::stof(value_str, &pos);
-							if (pos == value_str.size()) return f;
-						}
-						catch (...) {}
+		template<typename T>
+		struct is_duration : std::false_type {};
 
-						return value_str;
-					}
-					default: return value_str;
-				}
+		template<typename Rep, typename Period>
+		struct is_duration<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+		template<typename T>
+		inline constexpr bool is_duration_v = is_duration<T>::value;
+
+		/**
+		 * @brief The iterator over the command lines handed to ArgumentParser::parse_batch().
+		 */
+		template<typename Lines>
+		using line_iterator_t = decltype(std::begin(std::declval<const Lines&>()));
+
+		/**
+		 * @brief A min_value() or max_value() limit, kept in the type it was given in.
+		 */
+		using Bound = std::variant<int64_t, uint64_t, double>;
+
+		template<typename T>
+		Bound make_bound(T value)
+		{
+			if constexpr (is_duration_v<T>) {
+				return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(value).count());
 			}
-			catch (...) {
-				throw ArgumentError("Invalid value format");
+			else {
+				static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Bounds must be numbers or durations");
+				if constexpr (std::is_floating_point_v<T>) return static_cast<double>(value);
+				else if constexpr (std::is_signed_v<T>) return static_cast<int64_t>(value);
+				else return static_cast<uint64_t>(value);
 			}
 		}
-	};
-}
\ No newline at end of file
+
+		/**
+		 * @brief `a < b`, exact between signed and unsigned integers.
+		 */
+		template<typename A, typename B>
+		constexpr bool less(A a, B b)
+		{
+			if constexpr (std::is_integral_v<A> && std::is_integral_v<B> && !std::is_same_v<A, bool> && !std::is_same_v<B, bool>) {
+				return std::cmp_less(a, b);
+			}
+			else return a < b;
+		}
+
+		/**
+		 * @brief Whether `value < bound`.
+		 */
+		template<typename T>
+		bool below(T value, const Bound& bound)
+		{
+			return std::visit([&](auto limit) { return less(value, limit); }, bound);
+		}
+
+		/**
+		 * @brief Whether `value > bound`.
+		 */
+		template<typename T>
+		bool above(T value, const Bound& bound)
+		{
+			return std::visit([&](auto limit) { return less(limit, value); }, bound);
+		}
+
+		/**
+		 * @brief The values of T inside optional bounds as a plain [low, high], so a
+		 *        list can be range-checked without visiting a Bound per element.
+		 * @tparam T An integer type, or double for floating-point elements.
+		 * @return False if no value of T lies inside the bounds.
+		 */
+		template<typename T>
+		bool range_within(const std::optional<Bound>& min, const std::optional<Bound>& max, T& low, T& high)
+		{
+			using limits = std::numeric_limits<T>;
+			low = limits::has_infinity ? -limits::infinity() : limits::lowest();
+			high = limits::has_infinity ? limits::infinity() : limits::max();
+			auto narrow = [](const Bound& bound, bool lower, T& out) {
+				return std::visit([&](auto limit) {
+					using B = decltype(limit);
+					if constexpr (std::is_floating_point_v<T>) {
+						out = static_cast<T>(limit);
+						return true;
+					}
+					else if constexpr (std::is_floating_point_v<B>) {
+						// Rounds inwards; a double of magnitude 2^53 or more, or NaN, is already whole.
+						double edge = limit;
+						if (limit > -9007199254740992.0 && limit < 9007199254740992.0) {
+							const double whole = static_cast<double>(static_cast<int64_t>(limit));
+							edge = lower ? whole + (whole < limit) : whole - (whole > limit);
+						}
+						// 2^digits is the first double past limits::max(); limits::min() is exact.
+						const double past_max = static_cast<double>(limits::max() / 2 + 1) * 2.0;
+						if (edge != edge) return false;
+						if (edge >= past_max) { out = limits::max(); return !lower; }
+						if (edge < static_cast<double>(limits::min())) { out = limits::min(); return lower; }
+						out = static_cast<T>(edge);
+						return true;
+					}
+					else {
+						if (std::cmp_greater(limit, limits::max())) { out = limits::max(); return !lower; }
+						if (std::cmp_less(limit, limits::min())) { out = limits::min(); return lower; }
+						out = static_cast<T>(limit);
+						return true;
+					}
+				}, bound);
+			};
+			bool satisfiable = true;
+			if (min) satisfiable &= narrow(*min, true, low);
+			if (max) satisfiable &= narrow(*max, false, high);
+			return satisfiable && !(low > high);
+		}
+
+		inline ValueView to_view(const Value& value)
+		{
+			return std::visit([](const auto& held) -> ValueView { return held; }, value);
+		}
+
+		inline Value to_value(const ValueView& value)
+		{
+			return std::visit([](const auto& held) -> Value {
+				using T = std::decay_t<decltype(held)>;
+				if constexpr (std::is_same_v<T, std::string_view>) return std::string(held);
+				else if constexpr (std::is_same_v<T, ListView>) throw std::bad_variant_access();
+				else return held;
+			}, value);
+		}
+
+		/**
+		 * @brief Owns a custom validator without std::function.
+		 *
+		 * The callable is stored in an inline buffer, or on the heap only when it
+		 * does not fit, and is reached through one function pointer that the
+		 * compiler can inline the callable into. Callables taking
+		 * `std::string_view` or `const std::string&` see the raw text; any other
+		 * callable, such as `bool(int)`, is invoked on the converted value; a
+		 * duration can be taken as `std::chrono::nanoseconds`.
+		 */
+		class Validator
+		{
+			enum class Op { COPY, MOVE, DESTROY };
+
+			static constexpr size_t buffer_size = 4 * sizeof(void*);
+
+			alignas(std::max_align_t) unsigned char buffer_[buffer_size];
+			bool (*invoke_)(const void*, const ValueView&, std::string_view) = nullptr;
+			void (*manage_)(Op, void*, void*) = nullptr;
+			uint32_t types_ = 0;
+
+			template<typename F>
+			static constexpr bool fits_inline = sizeof(F) <= buffer_size &&
+				alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+			template<typename F>
+			static const F& target(const void* buffer)
+			{
+				if constexpr (fits_inline<F>) return *static_cast<const F*>(buffer);
+				else return **static_cast<F* const*>(buffer);
+			}
+
+			template<typename F>
+			static constexpr bool takes_text = std::is_invocable_r_v<bool, const F&, std::string_view> ||
+				std::is_invocable_r_v<bool, const F&, const std::string&>;
+
+			template<typename F, typename H>
+			static constexpr bool takes_value = !std::is_same_v<H, ListView> && (std::is_invocable_r_v<bool, const F&, const H&> ||
+				(std::is_same_v<H, int64_t> && std::is_invocable_r_v<bool, const F&, std::chrono::nanoseconds>));
+
+			/**
+			 * @brief One bit per ValueView alternative `F` can be invoked with; all bits if it takes the raw text.
+			 */
+			template<typename F, size_t... I>
+			static constexpr uint32_t accepted_types(std::index_sequence<I...>)
+			{
+				if constexpr (takes_text<F>) return ~0u;
+				else return ((takes_value<F, std::variant_alternative_t<I, ValueView>> ? 1u << I : 0u) | ...);
+			}
+
+			template<typename F>
+			static bool invoke(const void* buffer, const ValueView& value, std::string_view text)
+			{
+				const F& fn = target<F>(buffer);
+				if constexpr (std::is_invocable_r_v<bool, const F&, std::string_view>) {
+					return fn(text);
+				}
+				else if constexpr (std::is_invocable_r_v<bool, const F&, const std::string&>) {
+					return fn(std::string(text));
+				}
+				else {
+					return std::visit([&](const auto& held) {
+						using H = std::decay_t<decltype(held)>;
+						if constexpr (std::is_invocable_r_v<bool, const F&, decltype(held)>) return static_cast<bool>(fn(held));
+						else if constexpr (std::is_same_v<H, int64_t> && std::is_invocable_r_v<bool, const F&, std::chrono::nanoseconds>) {
+							return static_cast<bool>(fn(std::chrono::nanoseconds(held)));
+						}
+						else return false;
+					}, value);
+				}
+			}
+
+			template<typename F>
+			static void manage(Op op, void* dst, void* src)
+			{
+				if constexpr (fits_inline<F>) {
+					if (op == Op::COPY) ::new (dst) F(*static_cast<const F*>(src));
+					else if (op == Op::MOVE) ::new (dst) F(std::move(*static_cast<F*>(src)));
+					else static_cast<F*>(dst)->~F();
+				}
+				else {
+					if (op == Op::COPY) *static_cast<F**>(dst) = new F(**static_cast<F* const*>(src));
+					else if (op == Op::MOVE) *static_cast<F**>(dst) = std::exchange(*static_cast<F**>(src), nullptr);
+					else delete *static_cast<F**>(dst);
+				}
+			}
+
+		public:
+			Validator() = default;
+
+			template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Validator>>>
+			explicit Validator(F&& fn)
+			{
+				using Fn = std::decay_t<F>;
+				types_ = accepted_types<Fn>(std::make_index_sequence<std::variant_size_v<ValueView>>());
+				static_assert(accepted_types<Fn>(std::make_index_sequence<std::variant_size_v<ValueView>>()) != 0,
+					"a validator must take std::string_view, const std::string& or a converted value type");
+				if constexpr (fits_inline<Fn>) ::new (static_cast<void*>(buffer_)) Fn(std::forward<F>(fn));
+				else ::new (static_cast<void*>(buffer_)) Fn*(new Fn(std::forward<F>(fn)));
+				invoke_ = &invoke<Fn>;
+				manage_ = &manage<Fn>;
+			}
+
+			Validator(const Validator& other) : invoke_(other.invoke_), manage_(other.manage_), types_(other.types_)
+			{
+				if (manage_) manage_(Op::COPY, buffer_, const_cast<unsigned char*>(other.buffer_));
+			}
+
+			Validator(Validator&& other) noexcept : invoke_(other.invoke_), manage_(other.manage_), types_(other.types_)
+			{
+				if (manage_) manage_(Op::MOVE, buffer_, other.buffer_);
+			}
+
+			Validator& operator=(Validator other) noexcept
+			{
+				reset();
+				invoke_ = other.invoke_;
+				manage_ = other.manage_;
+				types_ = other.types_;
+				if (manage_) manage_(Op::MOVE, buffer_, other.buffer_);
+				return *this;
+			}
+
+			~Validator()
+			{
+				reset();
+			}
+
+			explicit operator bool() const
+			{
+				return invoke_ != nullptr;
+			}
+
+			/**
+			 * @brief Check whether the validator can take any of the ValueView alternatives in `types`.
+			 * @param types One bit per alternative index, e.g. `1u << ValueView(0).index()` for int.
+			 */
+			bool accepts(uint32_t types) const
+			{
+				return (types_ & types) != 0;
+			}
+
+			/**
+			 * @brief Runs the validator.
+			 * @param value The converted value.
+			 * @param text The raw text the value was converted from.
+			 * @return False if validation fails, including when a typed validator
+			 *         cannot accept the stored value type.
+			 */
+			bool operator()(const ValueView& value, std::string_view text) const
+			{
+				return invoke_(buffer_, value, text);
+			}
+
+		private:
+			void reset()
+			{
+				if (manage_) manage_(Op::DESTROY, buffer_, nullptr);
+				invoke_ = nullptr;
+				manage_ = nullptr;
+				types_ = 0;
+			}
+		};
+	}
+
+	namespace detail
+	{
+		/**
+		 * @brief Final avalanche step of MurmurHash3.
+		 */
+		constexpr uint64_t mix64(uint64_t x)
+		{
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdull;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ull;
+			x ^= x >> 33;
+			return x;
+		}
+
+		/**
+		 * @brief Hashes an option name eight bytes at a time.
+		 */
+		inline uint64_t hash_name(std::string_view name)
+		{
+			uint64_t h = 0x9E3779B97F4A7C15ull ^ name.size();
+			size_t i = 0;
+			for (; i + 8 <= name.size(); i += 8) {
+				uint64_t word;
+				std::memcpy(&word, name.data() + i, 8);
+				h = mix64(h ^ word);
+			}
+			uint64_t tail = 0;
+			if (i < name.size()) std::memcpy(&tail, name.data() + i, name.size() - i);
+			return mix64(h ^ tail);
+		}
+
+		/**
+		 * @brief Fast checksum of a large buffer, four independent 8-byte lanes at a time.
+		 */
+		inline uint64_t checksum(std::string_view data)
+		{
+			constexpr uint64_t k = 0x9E3779B97F4A7C15ull;
+			uint64_t lanes[4] = { k, k ^ 1, k ^ 2, k ^ 3 };
+			size_t i = 0;
+			for (; i + 32 <= data.size(); i += 32) {
+				for (size_t lane = 0; lane < 4; ++lane) {
+					uint64_t word;
+					std::memcpy(&word, data.data() + i + lane * 8, 8);
+					lanes[lane] = (lanes[lane] ^ word) * k;
+				}
+			}
+			uint64_t h = hash_name(data.substr(i)) ^ data.size();
+			for (uint64_t lane : lanes) h = mix64(h ^ lane);
+			return h;
+		}
+
+		/**
+		 * @brief Order-sensitive hash over a sequence of integers and strings.
+		 */
+		struct Hasher
+		{
+			uint64_t value = 0x243F6A8885A308D3ull;
+
+			void add(uint64_t x)
+			{
+				value = mix64(value ^ (x + 0x9E3779B97F4A7C15ull + (value << 6)));
+			}
+
+			void add(std::string_view text)
+			{
+				add(hash_name(text));
+			}
+		};
+
+		/**
+		 * @brief Maps a 32-bit value uniformly onto [0, range) without a division.
+		 */
+		constexpr uint32_t reduce(uint32_t value, uint32_t range)
+		{
+			return static_cast<uint32_t>((static_cast<uint64_t>(value) * range) >> 32);
+		}
+
+		/**
+		 * @brief Append-only store of a schema's argument names and aliases.
+		 *
+		 * Each name is copied once, into one of a few large blocks, and referred
+		 * to by a 32-bit id; an argument's aliases are chained after its name.
+		 * Blocks never move, so a view of a stored name stays valid for the
+		 * table's lifetime however many names are added after it. Each parser
+		 * owns its table; a copy of the parser copies it, keeping the ids.
+		 */
+		class NameTable
+		{
+			struct Record
+			{
+				const char* data;
+				uint32_t size;
+				uint32_t next;
+			};
+
+			static constexpr size_t block_size = 4096;
+
+			std::vector<std::unique_ptr<char[]>> blocks_;
+			char* cursor_ = nullptr;
+			size_t left_ = 0;
+			std::vector<Record> records_;
+
+			char* place(size_t size)
+			{
+				if (size > left_) {
+					const size_t bytes = std::max(size, block_size);
+					blocks_.push_back(std::make_unique_for_overwrite<char[]>(bytes));
+					// A name longer than a block gets one to itself; the current block keeps filling.
+					if (bytes > block_size) return blocks_.back().get();
+					cursor_ = blocks_.back().get();
+					left_ = bytes;
+				}
+				char* out = cursor_;
+				cursor_ += size;
+				left_ -= size;
+				return out;
+			}
+
+		public:
+			static constexpr uint32_t none = static_cast<uint32_t>(-1);
+
+			NameTable() = default;
+			NameTable& operator=(const NameTable&) = delete;
+
+			NameTable(const NameTable& other)
+			{
+				records_.reserve(other.records_.size());
+				for (const Record& record : other.records_) {
+					char* data = record.size ? place(record.size) : nullptr;
+					if (data) std::memcpy(data, record.data, record.size);
+					records_.push_back({ data, record.size, record.next });
+				}
+			}
+
+			/**
+			 * @brief The names chained after a stored name, e.g. an argument's aliases.
+			 */
+			class Chain
+			{
+				const NameTable* table_ = nullptr;
+				uint32_t first_ = none;
+
+			public:
+				class iterator
+				{
+					const NameTable* table_ = nullptr;
+					uint32_t id_ = none;
+
+				public:
+					using iterator_category = std::forward_iterator_tag;
+					using value_type = std::string_view;
+					using difference_type = std::ptrdiff_t;
+					using pointer = const std::string_view*;
+					using reference = std::string_view;
+
+					iterator() = default;
+					iterator(const NameTable* table, uint32_t id) : table_(table), id_(id) {}
+
+					std::string_view operator*() const { return (*table_)[id_]; }
+					iterator& operator++() { id_ = table_->next(id_); return *this; }
+					iterator operator++(int) { iterator old = *this; ++*this; return old; }
+					bool operator==(const iterator& other) const { return id_ == other.id_; }
+				};
+
+				Chain() = default;
+				Chain(const NameTable* table, uint32_t first) : table_(table), first_(first) {}
+
+				iterator begin() const { return { table_, first_ }; }
+				iterator end() const { return { table_, none }; }
+				bool empty() const { return first_ == none; }
+
+				size_t size() const
+				{
+					size_t count = 0;
+					for (uint32_t id = first_; id != none; id = table_->next(id)) ++count;
+					return count;
+				}
+			};
+
+			/**
+			 * @brief Stores a name.
+			 * @param name The text to copy.
+			 * @param after A stored name to chain this one after, e.g. an argument's latest alias, or none.
+			 * @return The new name's id.
+			 * @throws ArgumentError if the table already holds 2^32 - 1 names.
+			 */
+			uint32_t add(std::string_view name, uint32_t after = none)
+			{
+				if (records_.size() >= none || name.size() > std::numeric_limits<uint32_t>::max()) {
+					throw ArgumentError("Too many argument names");
+				}
+				char* data = name.empty() ? nullptr : place(name.size());
+				if (data) std::memcpy(data, name.data(), name.size());
+				const uint32_t id = static_cast<uint32_t>(records_.size());
+				records_.push_back({ data, static_cast<uint32_t>(name.size()), none });
+				if (after != none) records_[after].next = id;
+				return id;
+			}
+
+			std::string_view operator[](uint32_t id) const
+			{
+				const Record& record = records_[id];
+				return { record.data, record.size };
+			}
+
+			/**
+			 * @brief The name chained after `id`, or none.
+			 */
+			uint32_t next(uint32_t id) const
+			{
+				return records_[id].next;
+			}
+
+			Chain chain_after(uint32_t id) const
+			{
+				return { this, records_[id].next };
+			}
+
+			/**
+			 * @brief Number of names stored.
+			 */
+			size_t size() const
+			{
+				return records_.size();
+			}
+		};
+
+		/**
+		 * @brief Immutable lookup from names to positions, e.g. argument names and aliases.
+		 *
+		 * Built once when a parser is compiled. Names are either copied into one
+		 * buffer or, for a schema's NameTable, viewed in place; exact lookups go
+		 * through a perfect hash table, and a sorted flat array answers prefix
+		 * queries. The index is shared read-only between parses and threads.
+		 */
+		class NameIndex
+		{
+		public:
+			struct Entry
+			{
+				std::string_view name;
+				size_t index;
+
+				bool operator<(const Entry& other) const
+				{
+					return name < other.name;
+				}
+			};
+
+			/**
+			 * @brief Builds the index over a set of names.
+			 * @param names The names and the value each maps to; the text is copied.
+			 * @param duplicate_error Message prefix used if a name appears twice.
+			 * @throws ArgumentError if a name is used twice.
+			 */
+			NameIndex(std::span<const Entry> names, std::string_view duplicate_error)
+			{
+				size_t total = 0;
+				for (const auto& entry : names) total += entry.name.size();
+
+				// Reserved up front so the views below never dangle.
+				storage_.reserve(total);
+				entries_.reserve(names.size());
+				for (const auto& entry : names) {
+					entries_.push_back({ intern(entry.name), entry.index });
+				}
+				build(duplicate_error);
+			}
+
+			/**
+			 * @brief Builds the index over names whose text `owner` keeps alive, without copying it.
+			 * @param names The names and the value each maps to, viewing memory that `owner` holds.
+			 * @param duplicate_error Message prefix used if a name appears twice.
+			 * @param owner Shares ownership of the text, e.g. the schema's NameTable.
+			 * @throws ArgumentError if a name is used twice.
+			 */
+			NameIndex(std::span<const Entry> names, std::string_view duplicate_error, std::shared_ptr<const void> owner)
+				: owner_(std::move(owner)), entries_(names.begin(), names.end())
+			{
+				build(duplicate_error);
+			}
+
+			NameIndex(const NameIndex&) = delete;
+			NameIndex& operator=(const NameIndex&) = delete;
+
+			/**
+			 * @brief Finds the value mapped to a name, e.g. the position of an argument.
+			 * @param name The name; argument names are bare, without dashes.
+			 * @return The value, or std::nullopt if unknown.
+			 */
+			std::optional<size_t> find(std::string_view name) const
+			{
+				if (table_.empty()) return std::nullopt;
+				const Entry& entry = table_[slot_of(hash_name(name))];
+				if (entry.name != name || entry.index == empty_slot) return std::nullopt;
+				return entry.index;
+			}
+
+			/**
+			 * @brief All names and aliases starting with `prefix`, in sorted order.
+			 *
+			 * Two binary searches, so the cost does not grow with the number of matches.
+			 */
+			std::span<const Entry> with_prefix(std::string_view prefix) const
+			{
+				auto first = std::lower_bound(entries_.begin(), entries_.end(), Entry{ prefix, 0 });
+				auto last = std::partition_point(first, entries_.end(), [&](const Entry& entry) { return entry.name.starts_with(prefix); });
+				return { first, last };
+			}
+
+			const std::vector<Entry>& entries() const
+			{
+				return entries_;
+			}
+
+		private:
+			static constexpr size_t empty_slot = static_cast<size_t>(-1);
+
+			std::string storage_;
+			std::shared_ptr<const void> owner_;
+			std::vector<Entry> entries_;
+
+			// Perfect hash built with hash-and-displace: a name's hash picks a bucket,
+			// and the bucket's seed picks a slot that no other name maps to. A lookup
+			// is one hash, two array reads and one comparison, with no probing.
+			std::vector<uint32_t> seeds_;
+			std::vector<Entry> table_;
+
+			void build(std::string_view duplicate_error)
+			{
+				std::sort(entries_.begin(), entries_.end());
+				auto dup = std::adjacent_find(entries_.begin(), entries_.end(),
+					[](const Entry& a, const Entry& b) { return a.name == b.name; });
+				if (dup != entries_.end()) {
+					throw ArgumentError(std::string(duplicate_error) + std::string(dup->name));
+				}
+
+				build_table();
+			}
+
+			uint32_t bucket_of(uint64_t hash) const
+			{
+				return reduce(static_cast<uint32_t>(hash >> 32), static_cast<uint32_t>(seeds_.size()));
+			}
+
+			static uint32_t slot_for(uint64_t hash, uint32_t seed, uint32_t size)
+			{
+				return reduce(static_cast<uint32_t>(mix64(hash ^ (seed * 0x9E3779B97F4A7C15ull))), size);
+			}
+
+			uint32_t slot_of(uint64_t hash) const
+			{
+				return slot_for(hash, seeds_[bucket_of(hash)], static_cast<uint32_t>(table_.size()));
+			}
+
+			void build_table()
+			{
+				if (entries_.empty()) return;
+
+				std::vector<uint64_t> hashes(entries_.size());
+				for (size_t i = 0; i < entries_.size(); ++i) hashes[i] = hash_name(entries_[i].name);
+
+				// About four names per bucket and a table 25% larger than the name count
+				// keep every bucket's seed search down to a few attempts. A failed build
+				// retries with a larger table, which also spreads names over more buckets.
+				for (uint32_t size = static_cast<uint32_t>(entries_.size() + entries_.size() / 4 + 1);; size += size / 8 + 1) {
+					seeds_.assign(size / 5 + 1, 0);
+					if (place_all(hashes, size)) return;
+				}
+			}
+
+			bool place_all(const std::vector<uint64_t>& hashes, uint32_t size)
+			{
+				// Counting sort of names by bucket, then of buckets by size, largest
+				// first while the table is still mostly free.
+				const size_t bucket_count = seeds_.size();
+				std::vector<uint32_t> bucket(hashes.size());
+				std::vector<uint32_t> begin(bucket_count + 1, 0);
+				for (size_t i = 0; i < hashes.size(); ++i) {
+					bucket[i] = bucket_of(hashes[i]);
+					++begin[bucket[i] + 1];
+				}
+				size_t largest = 0;
+				for (size_t b = 0; b < bucket_count; ++b) largest = std::max<size_t>(largest, begin[b + 1]);
+				std::vector<uint32_t> by_size_begin(largest + 2, 0);
+				for (size_t b = 0; b < bucket_count; ++b) ++by_size_begin[largest - begin[b + 1] + 1];
+				for (size_t k = 0; k + 1 < by_size_begin.size(); ++k) by_size_begin[k + 1] += by_size_begin[k];
+				std::vector<uint32_t> order(bucket_count);
+				for (uint32_t b = 0; b < bucket_count; ++b) order[by_size_begin[largest - begin[b + 1]]++] = b;
+
+				for (size_t b = 0; b < bucket_count; ++b) begin[b + 1] += begin[b];
+				std::vector<uint32_t> members(hashes.size());
+				std::vector<uint32_t> fill(begin.begin(), begin.end() - 1);
+				for (uint32_t i = 0; i < hashes.size(); ++i) members[fill[bucket[i]]++] = i;
+
+				table_.assign(size, Entry{ std::string_view(), empty_slot });
+				uint32_t slots[64];
+				for (uint32_t b : order) {
+					const uint32_t* first = members.data() + begin[b];
+					const size_t count = begin[b + 1] - begin[b];
+					if (count == 0) break;
+					if (count > std::size(slots)) return false;
+
+					bool placed = false;
+					for (uint32_t seed = 0; seed < (1u << 16) && !placed; ++seed) {
+						placed = true;
+						for (size_t k = 0; k < count && placed; ++k) {
+							slots[k] = slot_for(hashes[first[k]], seed, size);
+							placed = table_[slots[k]].index == empty_slot && std::find(slots, slots + k, slots[k]) == slots + k;
+						}
+						if (placed) {
+							seeds_[b] = seed;
+							for (size_t k = 0; k < count; ++k) table_[slots[k]] = entries_[first[k]];
+						}
+					}
+					if (!placed) return false;
+				}
+				return true;
+			}
+
+			std::string_view intern(std::string_view name)
+			{
+				const size_t offset = storage_.size();
+				storage_ += name;
+				return std::string_view(storage_).substr(offset, name.size());
+			}
+		};
+
+		/**
+		 * @brief The frozen form of an argument's choices.
+		 */
+		struct ChoiceSet
+		{
+			NameIndex index;
+			std::string error;
+
+			ChoiceSet(std::span<const NameIndex::Entry> names, std::string message)
+				: index(names, "Duplicate choice: "), error(std::move(message))
+			{
+			}
+		};
+
+		/**
+		 * @brief An address unique to each enumeration, used to type-check choices_enum() keys.
+		 */
+		template<typename E>
+		inline constexpr char enum_tag = 0;
+	}
+
+	/**
+	 * @brief Time and allocations spent in each phase of setting up and running a parser.
+	 *
+	 * Collected only when the header is compiled with ARGPARSE_INSTRUMENTATION=1;
+	 * otherwise every counter stays zero and the hooks cost nothing. Allocations
+	 * are counted through the function given to set_allocation_counter().
+	 */
+	struct ParseStats
+	{
+		struct Phase
+		{
+			uint64_t calls = 0;
+			uint64_t nanoseconds = 0;
+			uint64_t allocations = 0;
+		};
+
+		static constexpr bool enabled = ARGPARSE_INSTRUMENTATION != 0;
+
+		Phase build_lookup;  ///< compile(): freezing choices and building the name lookup.
+		Phase tokenize;      ///< Scanning tokens and matching option names, per parse.
+		Phase env;           ///< Resolving env() fallbacks.
+		Phase validate;      ///< Range, choice and custom checks on scalar values.
+		Phase convert;       ///< Converting scalar values, and whole lists (checks included).
+		Phase help;          ///< Formatting help text.
+
+		/**
+		 * @brief One line such as `build_lookup=1x/12.5us/3a tokenize=...`.
+		 */
+		std::string summary() const
+		{
+			std::string out;
+			const std::pair<const char*, const Phase*> phases[] = {
+				{ "build_lookup", &build_lookup }, { "tokenize", &tokenize }, { "env", &env },
+				{ "validate", &validate }, { "convert", &convert }, { "help", &help } };
+			for (const auto& [name, phase] : phases) {
+				if (!out.empty()) out += ' ';
+				char buffer[32];
+				out += name;
+				out += '=';
+				out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), phase->calls).ptr);
+				out += "x/";
+				out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), phase->nanoseconds / 1000.0, std::chars_format::fixed, 1).ptr);
+				out += "us/";
+				out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), phase->allocations).ptr);
+				out += 'a';
+			}
+			return out;
+		}
+	};
+
+	/**
+	 * @brief Returns the process-wide number of allocations so far, e.g. from a counting operator new.
+	 */
+	using AllocationCounter = uint64_t (*)();
+
+	namespace detail
+	{
+		inline std::atomic<AllocationCounter> allocation_counter{ nullptr };
+
+		enum class PhaseId { BUILD_LOOKUP, TOKENIZE, ENV, VALIDATE, CONVERT, HELP, COUNT };
+
+		/**
+		 * @brief Live counters of one parser; updated concurrently by parses on any thread.
+		 */
+		struct StatsCounters
+		{
+			struct Counter
+			{
+				std::atomic<uint64_t> calls{ 0 };
+				std::atomic<uint64_t> nanoseconds{ 0 };
+				std::atomic<uint64_t> allocations{ 0 };
+			};
+			Counter phases[static_cast<size_t>(PhaseId::COUNT)];
+		};
+
+#if ARGPARSE_INSTRUMENTATION
+		/**
+		 * @brief The counters of the parser running on this thread, so Argument hooks can find them.
+		 */
+		inline thread_local StatsCounters* active_counters = nullptr;
+
+		inline uint64_t allocations_now()
+		{
+			AllocationCounter counter = allocation_counter.load(std::memory_order_relaxed);
+			return counter ? counter() : 0;
+		}
+
+		/**
+		 * @brief Adds the time and allocations of its own lifetime to one phase.
+		 */
+		class PhaseTimer
+		{
+			StatsCounters* counters_;
+			PhaseId phase_;
+			std::chrono::steady_clock::time_point start_;
+			uint64_t allocations_;
+
+		public:
+			PhaseTimer(StatsCounters* counters, PhaseId phase) : counters_(counters), phase_(phase)
+			{
+				if (!counters_) return;
+				allocations_ = allocations_now();
+				start_ = std::chrono::steady_clock::now();
+			}
+
+			PhaseTimer(const PhaseTimer&) = delete;
+			PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+			~PhaseTimer()
+			{
+				if (!counters_) return;
+				const auto elapsed = std::chrono::steady_clock::now() - start_;
+				auto& counter = counters_->phases[static_cast<size_t>(phase_)];
+				counter.calls.fetch_add(1, std::memory_order_relaxed);
+				counter.nanoseconds.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()), std::memory_order_relaxed);
+				counter.allocations.fetch_add(allocations_now() - allocations_, std::memory_order_relaxed);
+			}
+		};
+
+		/**
+		 * @brief Makes a parser's counters the active ones for the current scope.
+		 */
+		class ActiveCounters
+		{
+			StatsCounters* previous_;
+
+		public:
+			explicit ActiveCounters(StatsCounters* counters) : previous_(active_counters)
+			{
+				active_counters = counters;
+			}
+
+			ActiveCounters(const ActiveCounters&) = delete;
+			ActiveCounters& operator=(const ActiveCounters&) = delete;
+
+			~ActiveCounters()
+			{
+				active_counters = previous_;
+			}
+		};
+#endif
+	}
+
+	/**
+	 * @brief Sets the function instrumentation uses to count allocations.
+	 * @param counter Returns a running allocation count; nullptr disables allocation counting.
+	 */
+	inline void set_allocation_counter(AllocationCounter counter)
+	{
+		detail::allocation_counter.store(counter, std::memory_order_relaxed);
+	}
+
+#if ARGPARSE_INSTRUMENTATION
+#define ARGPARSE_PHASE(phase) ::argparse::detail::PhaseTimer argparse_phase_timer_(::argparse::detail::active_counters, ::argparse::detail::PhaseId::phase)
+#define ARGPARSE_PHASE_FOR(counters, phase) ::argparse::detail::PhaseTimer argparse_phase_timer_(counters, ::argparse::detail::PhaseId::phase)
+#else
+#define ARGPARSE_PHASE(phase) ((void)0)
+#define ARGPARSE_PHASE_FOR(counters, phase) ((void)0)
+#endif
+
+	/**
+	 * @brief Read-only copy of the process environment, indexed by variable name.
+	 *
+	 * Captured once and shared by every parse, so arguments with an `env()`
+	 * fallback resolve with a hash lookup instead of calling `getenv` each time.
+	 * All strings live in one buffer owned by the snapshot.
+	 */
+	class EnvSnapshot
+	{
+		std::vector<char> storage_;
+		std::unordered_map<std::string_view, std::string_view> values_;
+
+	public:
+		/**
+		 * @brief Builds a snapshot from a "NAME=VALUE" array such as `environ` or `envp`.
+		 * @param envp Null-terminated array of entries; may be null.
+		 */
+		explicit EnvSnapshot(const char* const* envp)
+		{
+			size_t total = 0;
+			size_t count = 0;
+			for (auto entry = envp; entry && *entry; ++entry, ++count) {
+				total += std::char_traits<char>::length(*entry);
+			}
+
+			storage_.reserve(total);
+			values_.reserve(count);
+			for (auto entry = envp; entry && *entry; ++entry) {
+				const std::string_view text(*entry);
+				const size_t eq = text.find('=');
+				if (eq == std::string_view::npos || eq == 0) continue;
+
+				const char* base = storage_.data() + storage_.size();
+				storage_.insert(storage_.end(), text.begin(), text.end());
+				// The first occurrence wins, matching getenv.
+				values_.emplace(std::string_view(base, eq), std::string_view(base + eq + 1, text.size() - eq - 1));
+			}
+		}
+
+		EnvSnapshot(EnvSnapshot&&) = default;
+		EnvSnapshot& operator=(EnvSnapshot&&) = default;
+		EnvSnapshot(const EnvSnapshot&) = delete;
+		EnvSnapshot& operator=(const EnvSnapshot&) = delete;
+
+		/**
+		 * @brief Captures the current process environment.
+		 * @return A snapshot of `environ`.
+		 */
+		static EnvSnapshot capture()
+		{
+#if defined(_WIN32)
+			return EnvSnapshot(_environ);
+#else
+			return EnvSnapshot(environ);
+#endif
+		}
+
+		/**
+		 * @brief Looks up a variable.
+		 * @param name The variable name.
+		 * @return A view of its value, or std::nullopt if it was not set.
+		 */
+		std::optional<std::string_view> get(std::string_view name) const
+		{
+			auto it = values_.find(name);
+			if (it == values_.end()) return std::nullopt;
+			return it->second;
+		}
+
+		size_t size() const
+		{
+			return values_.size();
+		}
+	};
+
+	/**
+	 * @brief Settings from an INI-style configuration file.
+	 *
+	 * Each line is `key = value`; `[section]` headers prefix the keys that
+	 * follow with "section.", which is where subcommand parsers look for
+	 * theirs. Lines starting with '#' or ';' are comments, as is anything
+	 * after whitespace and '#' in an unquoted value. Values may be quoted
+	 * with '...' or "..." and use backslash escapes, as in response files.
+	 * A key set twice keeps its last value.
+	 *
+	 * The file is memory-mapped and unquoted in place, so values are views
+	 * into the mapping; a 500-line file costs one map and one key table.
+	 */
+	class ConfigFile
+	{
+		detail::MappedFile file_;
+		detail::StringMap<std::string_view> values_;
+
+		static std::string_view trim(std::string_view text)
+		{
+			constexpr std::string_view blanks = " \t\r\f\v";
+			const size_t first = text.find_first_not_of(blanks);
+			if (first == std::string_view::npos) return {};
+			return text.substr(first, text.find_last_not_of(blanks) - first + 1);
+		}
+
+		/**
+		 * @brief Splits the buffer into keys and values.
+		 * @throws ArgumentError naming `origin` and the line if a line is malformed.
+		 */
+		void load(const std::string& origin)
+		{
+			std::string section;
+			size_t line_number = 0;
+			for (char* pos = file_.begin(); pos < file_.end();) {
+				char* line_end = static_cast<char*>(std::memchr(pos, '\n', static_cast<size_t>(file_.end() - pos)));
+				if (!line_end) line_end = file_.end();
+				++line_number;
+				const std::string_view line = trim(std::string_view(pos, static_cast<size_t>(line_end - pos)));
+				pos = line_end + (line_end < file_.end());
+
+				auto invalid = [&](std::string_view text) {
+					return ArgumentError("Invalid config line " + std::to_string(line_number) + " in " + origin + ": " + std::string(text));
+				};
+				if (line.empty() || line.front() == '#' || line.front() == ';') continue;
+				if (line.front() == '[') {
+					if (line.back() != ']') throw invalid(line);
+					section = std::string(trim(line.substr(1, line.size() - 2)));
+					if (!section.empty()) section += '.';
+					continue;
+				}
+
+				const size_t eq = line.find('=');
+				const std::string_view key = eq == std::string_view::npos ? std::string_view() : trim(line.substr(0, eq));
+				if (key.empty()) throw invalid(line);
+
+				char* begin = const_cast<char*>(line.data()) + eq + 1;
+				char* const end = const_cast<char*>(line.data()) + line.size();
+				while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+				std::string_view value;
+				if (begin < end && (*begin == '"' || *begin == '\'')) {
+					// Unquoting rewrites the line, so keep it for the error message.
+					const std::string original(line);
+					value = detail::next_text_token(begin, end).value_or(std::string_view());
+					const std::string_view rest = trim(std::string_view(begin, static_cast<size_t>(end - begin)));
+					if (!rest.empty() && rest.front() != '#' && rest.front() != ';') throw invalid(original);
+				}
+				else {
+					value = std::string_view(begin, static_cast<size_t>(end - begin));
+					for (size_t i = 1; i < value.size(); ++i) {
+						if ((value[i] == '#' || value[i] == ';') && (value[i - 1] == ' ' || value[i - 1] == '\t')) {
+							value = value.substr(0, i);
+							break;
+						}
+					}
+					value = trim(value);
+				}
+				values_.insert_or_assign(section + std::string(key), value);
+			}
+		}
+
+		explicit ConfigFile(detail::MappedFile file) : file_(std::move(file)) {}
+
+	public:
+		ConfigFile(ConfigFile&&) = default;
+		ConfigFile& operator=(ConfigFile&&) = default;
+		ConfigFile(const ConfigFile&) = delete;
+		ConfigFile& operator=(const ConfigFile&) = delete;
+
+		/**
+		 * @brief Maps and reads a configuration file.
+		 * @param path Path of the file.
+		 * @return The settings, or std::nullopt if the file cannot be read.
+		 * @throws ArgumentError if a line is malformed.
+		 */
+		static std::optional<ConfigFile> open(const std::string& path)
+		{
+			auto file = detail::MappedFile::open(path);
+			if (!file) return std::nullopt;
+			ConfigFile config(std::move(*file));
+			config.load(path);
+			return config;
+		}
+
+		/**
+		 * @brief Reads settings from text held in memory; the text is copied.
+		 * @throws ArgumentError if a line is malformed.
+		 */
+		static ConfigFile from_string(std::string_view text)
+		{
+			ConfigFile config(detail::MappedFile::copy(text));
+			config.load("<string>");
+			return config;
+		}
+
+		/**
+		 * @brief Looks up a setting.
+		 * @param key The key, "section.key" for keys under a section header.
+		 * @return A view of its value, or std::nullopt if it is not set.
+		 */
+		std::optional<std::string_view> get(std::string_view key) const
+		{
+			auto it = values_.find(key);
+			if (it == values_.end()) return std::nullopt;
+			return it->second;
+		}
+
+		size_t size() const
+		{
+			return values_.size();
+		}
+	};
+
+	/**
+	 * @brief Represents a command-line argument with metadata and validation.
+	 *
+	 * Supports various data types, default values,
+	 * choices, flags, and custom validation logic.
+	 */
+	class Argument
+	{
+	public:
+		/**
+		 * @brief Enumerates supported argument types.
+		 *
+		 * DURATION values are int64_t nanoseconds and SIZE values uint64_t bytes,
+		 * both parsed from text with a unit, such as "250ms" or "64GiB".
+		 */
+		enum class ArgType { INT, FLOAT, STRING, BOOL, AUTO, INT64, UINT64, DOUBLE, DURATION, SIZE };
+
+		/**
+		 * @brief A converted argument value.
+		 */
+		using Value = detail::Value;
+		using ValueView = detail::ValueView;
+		using Code = ParseError::Code;
+
+		/**
+		 * @brief Upper bound for nargs() meaning "as many values as follow".
+		 */
+		static constexpr size_t unbounded = static_cast<size_t>(-1);
+
+	private:
+		detail::NameTable* names_;
+		uint32_t name_id_;
+		uint32_t last_alias_id_;
+		std::string help_;
+		bool required_ = false;
+		Value default_value_;
+		bool is_flag_ = false;
+		std::optional<detail::Bound> min_value_;
+		std::optional<detail::Bound> max_value_;
+		std::optional<std::string> env_var_;
+		std::vector<std::string> choices_;
+		ArgType type_ = ArgType::AUTO;
+		detail::Validator custom_validator_;
+		std::optional<std::string> custom_validator_error_;
+		std::vector<int> choice_values_;
+		const void* enum_tag_ = nullptr;
+		std::shared_ptr<const detail::ChoiceSet> choice_set_;
+		size_t nargs_min_ = 1;
+		size_t nargs_max_ = 1;
+		bool append_ = false;
+		char delimiter_ = 0;
+		size_t index_ = 0;
+
+
+		/**
+		 * @brief Stores a numeric default as the type the 64-bit and unit types hold.
+		 */
+		void coerce_default()
+		{
+			std::visit([&](const auto& held) {
+				using H = std::decay_t<decltype(held)>;
+				if constexpr (std::is_arithmetic_v<H> && !std::is_same_v<H, bool>) {
+					switch (type_) {
+						case ArgType::INT64: case ArgType::DURATION: default_value_ = static_cast<int64_t>(held); break;
+						case ArgType::UINT64: case ArgType::SIZE: default_value_ = static_cast<uint64_t>(held); break;
+						case ArgType::DOUBLE: default_value_ = static_cast<double>(held); break;
+						default: break;
+					}
+				}
+			}, default_value_);
+		}
+
+		/**
+		 * @brief One bit per ValueView alternative a converted value of this argument can hold.
+		 */
+		uint32_t held_types() const
+		{
+			constexpr auto bit = [](auto value) { return 1u << ValueView(value).index(); };
+			if (!choice_values_.empty()) return bit(0);
+			switch (type_) {
+				case ArgType::INT: return bit(0);
+				case ArgType::FLOAT: return bit(0.0f);
+				case ArgType::STRING: return bit(std::string_view());
+				case ArgType::BOOL: return bit(false);
+				case ArgType::INT64: case ArgType::DURATION: return bit(int64_t(0));
+				case ArgType::UINT64: case ArgType::SIZE: return bit(uint64_t(0));
+				case ArgType::DOUBLE: return bit(0.0);
+				default: return bit(0) | bit(0.0f) | bit(std::string_view());
+			}
+		}
+
+		/**
+		 * @brief Rejects a typed custom validator that cannot take this argument's converted value.
+		 * @throws ArgumentError if it would never be called with a value it accepts.
+		 */
+		void check_validator(const detail::Validator& validator) const
+		{
+			if (validator && !validator.accepts(held_types())) {
+				throw ArgumentError("Custom validator does not accept the argument's type: --" + std::string(name()));
+			}
+		}
+
+	public:
+		/**
+		 * @brief Constructs an Argument with a given name.
+		 * @param names The schema's name table, which stores the name and aliases.
+		 * @param name The name of the argument (e.g., "input", "verbose").
+		 */
+		Argument(detail::NameTable& names, std::string_view name)
+			: names_(&names), name_id_(names.add(name)), last_alias_id_(name_id_)
+		{
+		}
+
+		/**
+		 * @brief Sets the help message shown in the generated help text.
+		 * @param text Help description.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& help(std::string text) { help_ = std::move(text); return *this; }
+
+		/**
+		 * @brief Marks the argument as required.
+		 * @param req Set to true if the argument is required (default: true).
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& required(bool req = true) { required_ = req; return *this; }
+
+		/**
+		 * @brief Adds an alias (short name) for the argument.
+		 * @param alias The alias (e.g., "v" for verbose).
+		 * @return Reference to the current Argument instance.
+		 * @throws ArgumentError if alias is empty or duplicates the name.
+		 */
+		Argument& add_alias(std::string_view alias)
+		{
+			alias = detail::strip_dashes(alias);
+			if (alias.empty() || alias == name()) {
+				throw ArgumentError("Invalid alias");
+			}
+			last_alias_id_ = names_->add(alias, last_alias_id_);
+			return *this;
+		}
+
+
+		bool is_required() const
+		{
+			return required_;
+		}
+
+		/**
+		 * @brief Position of this argument in its parser, used by ArgKey.
+		 */
+		size_t index() const
+		{
+			return index_;
+		}
+
+		/**
+		 * @brief The name, stored in the schema's name table.
+		 */
+		std::string_view name() const
+		{
+			return (*names_)[name_id_];
+		}
+
+		/**
+		 * @brief The aliases in the order they were added.
+		 */
+		detail::NameTable::Chain aliases() const
+		{
+			return names_->chain_after(name_id_);
+		}
+
+		/**
+		 * @brief Id of the name in the schema's name table.
+		 */
+		uint32_t name_id() const
+		{
+			return name_id_;
+		}
+
+		const std::string& help() const
+		{
+			return help_;
+		}
+
+		const ArgType type() const
+		{
+			return type_;
+		}
+
+		bool is_flag() const
+		{
+			return is_flag_;
+		}
+
+		const auto& default_value() const
+		{
+			return default_value_;
+		}
+
+		const std::vector<std::string>& choices() const
+		{
+			return choices_;
+		}
+
+		std::optional<std::string> get_env_value() const
+		{
+			auto value = env_value();
+			if (!value) return std::nullopt;
+			return std::string(*value);
+		}
+
+		/**
+		 * @brief Resolves the environment fallback without copying it.
+		 * @param snapshot Snapshot to read from; if null, `getenv` is used.
+		 * @return A view of the value, or std::nullopt if no variable is configured or set.
+		 */
+		std::optional<std::string_view> env_value(const EnvSnapshot* snapshot = nullptr) const
+		{
+			if (!env_var_) return std::nullopt;
+			ARGPARSE_PHASE(ENV);
+			if (snapshot) return snapshot->get(*env_var_);
+			const char* value = std::getenv(env_var_->c_str());
+			if (!value) return std::nullopt;
+			return std::string_view(value);
+		}
+
+		/**
+		 * @brief Sets a default value for the argument.
+		 *
+		 * A number is stored as the argument's type once that is one of the
+		 * 64-bit or unit types, so `type_size().default_value(4096)` holds bytes.
+		 *
+		 * @tparam T Type of the value (int, float, string, bool, another arithmetic type, or a std::chrono::duration).
+		 * @param val The default value.
+		 * @return Reference to the current Argument instance.
+		 */
+		template<typename T>
+		Argument& default_value(T val);
+
+		/**
+		 * @brief Treats this argument as a flag (boolean switch).
+		 * @param set Whether to enable flag behavior (default: true).
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& flag(bool set = true)
+		{
+			is_flag_ = set;
+			if (set) default_value_ = false;
+			return *this;
+		}
+
+		/**
+		 * @brief Makes each occurrence consume exactly `count` values.
+		 * @param count Number of values per occurrence.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& nargs(size_t count)
+		{
+			return nargs(count, count);
+		}
+
+		/**
+		 * @brief Makes each occurrence consume between `min` and `max` values.
+		 *
+		 * The argument becomes list-valued; read it with ParsedArgs::get_list.
+		 *
+		 * @param min Fewest values accepted per occurrence.
+		 * @param max Most values consumed per occurrence, or Argument::unbounded.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& nargs(size_t min, size_t max)
+		{
+			nargs_min_ = min;
+			nargs_max_ = std::max(min, max);
+			return *this;
+		}
+
+		/**
+		 * @brief Collects values from every occurrence instead of keeping the last one.
+		 * @param set Whether to append (default: true).
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& append(bool set = true)
+		{
+			append_ = set;
+			return *this;
+		}
+
+		/**
+		 * @brief Splits each value at `separator`, e.g. `--ids 1,2,3`.
+		 * @param separator The separator character.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& delimiter(char separator = ',')
+		{
+			delimiter_ = separator;
+			return *this;
+		}
+
+		/**
+		 * @brief Check whether the argument holds a list of values.
+		 */
+		bool is_list() const
+		{
+			return append_ || delimiter_ || nargs_min_ != 1 || nargs_max_ != 1;
+		}
+
+		size_t nargs_min() const
+		{
+			return nargs_min_;
+		}
+
+		size_t nargs_max() const
+		{
+			return nargs_max_;
+		}
+
+		bool is_append() const
+		{
+			return append_;
+		}
+
+		char list_delimiter() const
+		{
+			return delimiter_;
+		}
+
+		/**
+		 * @brief The element type of a list argument; AUTO lists hold strings.
+		 */
+		detail::ElementType element_type() const
+		{
+			switch (type_) {
+				case ArgType::INT: return detail::ElementType::INT;
+				case ArgType::FLOAT: return detail::ElementType::FLOAT;
+				case ArgType::BOOL: return detail::ElementType::BOOL;
+				case ArgType::INT64: case ArgType::DURATION: return detail::ElementType::INT64;
+				case ArgType::UINT64: case ArgType::SIZE: return detail::ElementType::UINT64;
+				case ArgType::DOUBLE: return detail::ElementType::DOUBLE;
+				default: return detail::ElementType::STRING;
+			}
+		}
+
+		/**
+		 * @brief Sets the minimum value (applies to every numeric type except AUTO).
+		 *
+		 * The bound keeps its own type, so `min_value(-1)` on a UINT64 argument
+		 * and `min_value(0.5)` on an INT argument compare exactly.
+		 *
+		 * @param val The minimum allowed value; a std::chrono::duration for DURATION arguments.
+		 * @return Reference to the current Argument instance.
+		 */
+		template<typename T>
+		Argument& min_value(T val)
+		{
+			min_value_ = detail::make_bound(val);
+			return *this;
+		}
+
+		/**
+		 * @brief Sets the maximum value (applies to every numeric type except AUTO).
+		 * @param val The maximum allowed value; a std::chrono::duration for DURATION arguments.
+		 * @return Reference to the current Argument instance.
+		 */
+		template<typename T>
+		Argument& max_value(T val)
+		{
+			max_value_ = detail::make_bound(val);
+			return *this;
+		}
+
+		/**
+		 * @brief Sets an environment variable to use as a fallback value.
+		 * @param var_name Name of the environment variable.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& env(const std::string& var_name)
+		{
+			env_var_ = var_name;
+			return *this;
+		}
+
+		/**
+		 * @brief Restricts acceptable values to a list of choices.
+		 * @param options A list of valid string options.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& choices(std::vector<std::string> options)
+		{
+			choices_ = std::move(options);
+			choice_values_.clear();
+			enum_tag_ = nullptr;
+			choice_set_.reset();
+			return *this;
+		}
+
+		/**
+		 * @brief Restricts values to named choices and stores the matching enumerator.
+		 *
+		 * The parsed value is read back as `E` with `get<E>()` or an `ArgKey<E>`,
+		 * so no string comparison is needed after parsing. The default is `E{}`
+		 * unless set with `default_value(E)`.
+		 *
+		 * @code
+		 * enum class Codec { H264, VP9 };
+		 * parser.add_argument("codec").choices_enum<Codec>({ { "h264", Codec::H264 }, { "vp9", Codec::VP9 } });
+		 * @endcode
+		 *
+		 * @tparam E An enumeration whose values fit in an int.
+		 * @param mapping Each accepted string and the enumerator it stands for.
+		 * @return Reference to the current Argument instance.
+		 */
+		template<typename E>
+		Argument& choices_enum(std::vector<std::pair<std::string, E>> mapping)
+		{
+			static_assert(std::is_enum_v<E>, "choices_enum requires an enumeration type");
+			static_assert(sizeof(E) <= sizeof(int), "choices_enum values are stored as int");
+
+			std::vector<std::string> names;
+			std::vector<int> values;
+			names.reserve(mapping.size());
+			values.reserve(mapping.size());
+			for (auto& [text, value] : mapping) {
+				names.push_back(std::move(text));
+				values.push_back(static_cast<int>(value));
+			}
+			choices(std::move(names));
+			choice_values_ = std::move(values);
+			enum_tag_ = &detail::enum_tag<E>;
+			type_ = ArgType::STRING;
+			if (!std::holds_alternative<int>(default_value_)) default_value_ = 0;
+			check_validator(custom_validator_);
+			return *this;
+		}
+
+		/**
+		 * @brief Check whether choices_enum() maps this argument's choices to enumerators of `E`.
+		 */
+		template<typename E>
+		bool is_enum() const
+		{
+			return enum_tag_ == &detail::enum_tag<E>;
+		}
+
+		/**
+		 * @brief The choice whose enumerator equals `value`, or nullptr.
+		 */
+		const std::string* choice_name(int value) const
+		{
+			for (size_t i = 0; i < choice_values_.size(); ++i) {
+				if (choice_values_[i] == value) return &choices_[i];
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief Specifies that the argument expects an integer value.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_int()
+		{
+			return set_type<int>(ArgType::INT, 0);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a float value.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_float()
+		{
+			return set_type<float>(ArgType::FLOAT, 0.0f);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a string value.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_string()
+		{
+			return set_type<std::string>(ArgType::STRING, std::string());
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a boolean value.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_bool()
+		{
+			return set_type<bool>(ArgType::BOOL, false);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a 64-bit signed integer.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_int64()
+		{
+			return set_type<int64_t>(ArgType::INT64, 0);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a 64-bit unsigned integer.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_uint64()
+		{
+			return set_type<uint64_t>(ArgType::UINT64, 0);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a double-precision value.
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_double()
+		{
+			return set_type<double>(ArgType::DOUBLE, 0.0);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a duration such as "250ms" or "1h30m".
+		 *
+		 * The value is read back as any `std::chrono::duration`, or as int64_t nanoseconds.
+		 *
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_duration()
+		{
+			return set_type<int64_t>(ArgType::DURATION, 0);
+		}
+
+		/**
+		 * @brief Specifies that the argument expects a byte size such as "4096", "512KiB" or "64GiB".
+		 *
+		 * The value is read back as uint64_t bytes.
+		 *
+		 * @return Reference to the current Argument instance.
+		 */
+		Argument& type_size()
+		{
+			return set_type<uint64_t>(ArgType::SIZE, 0);
+		}
+
+		template<typename T>
+		Argument& set_type(ArgType arg_type, T default_val)
+		{
+			type_ = arg_type;
+			coerce_default();
+			check_validator(custom_validator_);
+			if (std::holds_alternative<T>(default_value_)) return *this;
+			default_value_ = default_val;
+			return *this;
+		}
+
+		/**
+		 * @brief Adds a custom validation function.
+		 *
+		 * A callable taking `std::string_view` or `const std::string&` receives the
+		 * raw value. A callable taking the converted type, e.g. `bool(int)` for an
+		 * INT argument, runs on the already converted value without parsing again.
+		 * A typed callable must accept the type the argument declares, before or
+		 * after this call; an AUTO argument needs it to take int, float or text.
+		 *
+		 * @param validate_fn A function that returns true if valid.
+		 * @param error_message Message to show if validation fails.
+		 * @return Reference to the current Argument instance.
+		 * @throws ArgumentError if the callable cannot take the argument's converted value.
+		 */
+		template<typename F>
+		Argument& custom_validation(F&& validate_fn, const std::string& error_message)
+		{
+			detail::Validator validator(std::forward<F>(validate_fn));
+			check_validator(validator);
+			custom_validator_ = std::move(validator);
+			custom_validator_error_ = error_message;
+			return *this;
+		}
+
+		/**
+		 * @brief Validates the provided string value.
+		 * @param value_str The string to validate.
+		 * @throws ArgumentError if validation fails.
+		 */
+		void validate(std::string_view value_str) const
+		{
+			(void)convert_view(value_str);
+		}
+
+		/**
+		 * @brief Validates and converts a string value in a single pass.
+		 * @param value_str The raw value.
+		 * @return The converted value.
+		 * @throws ArgumentError if the value does not parse or validation fails.
+		 */
+		Value convert(std::string_view value_str) const
+		{
+			return detail::to_value(convert_view(value_str));
+		}
+
+		/**
+		 * @brief Validates and converts a string value without copying it.
+		 *
+		 * The token is parsed exactly once; range checks, choices and the custom
+		 * validator all run against that one result. A string result is a view
+		 * into `value_str`.
+		 *
+		 * @param value_str The raw value.
+		 * @return The converted value.
+		 * @throws ArgumentError if the value does not parse or validation fails.
+		 */
+		ValueView convert_view(std::string_view value_str) const
+		{
+			ValueView value;
+			const Code code = try_convert(value_str, value);
+			if (code != Code::NONE) throw ArgumentError(describe(code, value_str));
+			return value;
+		}
+
+		/**
+		 * @brief Non-throwing convert_view().
+		 * @param value_str The raw value.
+		 * @param out Receives the converted value on success.
+		 * @return Code::NONE, or why the value was rejected; describe() turns it into text.
+		 */
+		Code try_convert(std::string_view value_str, ValueView& out) const
+		{
+			if (!choice_values_.empty()) {
+				ARGPARSE_PHASE(VALIDATE);
+				auto pos = find_choice(value_str);
+				if (!pos) return Code::INVALID_CHOICE;
+				out = choice_values_[*pos];
+				return check_custom(out, value_str);
+			}
+			Code code;
+			{
+				ARGPARSE_PHASE(CONVERT);
+				code = try_convert_value(value_str, type_, out);
+			}
+			if (code != Code::NONE) return code;
+			ARGPARSE_PHASE(VALIDATE);
+			return std::visit([&](const auto& held) { return check(held, value_str); }, out);
+		}
+
+		/**
+		 * @brief The error text for a code returned by try_convert() or convert_elements().
+		 * @param code The code.
+		 * @param value_str The rejected value.
+		 */
+		std::string describe(Code code, std::string_view value_str) const
+		{
+			switch (code)
+			{
+				case Code::BELOW_MINIMUM: return "Value must be >= " + format_bound(min_value_);
+				case Code::ABOVE_MAXIMUM: return "Value must be <= " + format_bound(max_value_);
+				case Code::INVALID_CHOICE:
+					return choice_set_ ? choice_set_->error : "Invalid choice. Options: " + join_strings(choices_, ", ");
+				case Code::VALIDATION_FAILED: return custom_validator_error_.value_or("Validation failed.");
+				default: return describe_value(code, value_str);
+			}
+		}
+
+		/**
+		 * @brief Counts the elements a list argument will hold.
+		 * @param tokens The raw values given for the argument.
+		 * @param string_bytes Incremented by the bytes string elements need.
+		 * @return The number of elements.
+		 */
+		size_t count_elements(std::span<const std::string_view> tokens, size_t& string_bytes) const
+		{
+			size_t count = 0;
+			for (std::string_view token : tokens) {
+				const size_t separators = delimiter_ ? detail::count_byte(token, delimiter_) : 0;
+				count += separators + 1;
+				if (element_type() == detail::ElementType::STRING) string_bytes += token.size() - separators;
+			}
+			return count;
+		}
+
+		/**
+		 * @brief Converts and validates every element of a list argument in one batch.
+		 *
+		 * Elements are parsed straight into `out`, with no per-element variant.
+		 * String elements are views into `tokens`. Numeric lists without choices
+		 * or a custom validator take a tight loop that range-checks each number
+		 * as it is parsed.
+		 *
+		 * @tparam T The element type matching element_type().
+		 * @param tokens The raw values given for the argument.
+		 * @param out Destination with room for count_elements() elements.
+		 * @param culprit Set to the rejected element on failure.
+		 * @return Code::NONE, or why an element was rejected.
+		 */
+		template<typename T>
+		Code convert_elements(std::span<const std::string_view> tokens, T* out, std::string_view& culprit) const
+		{
+			if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+				if (!custom_validator_ && (type_ == ArgType::INT || choices_.empty())) {
+					return convert_numbers(tokens, out, culprit);
+				}
+			}
+			Code code = Code::NONE;
+			for (std::string_view token : tokens) {
+				const bool complete = detail::for_each_piece(token, delimiter_, [&](std::string_view piece) {
+					T value{};
+					if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+						auto number = parse_element<T>(piece);
+						if (!number) code = number_error<T>(piece);
+						else value = *number;
+					}
+					else if constexpr (std::is_same_v<T, bool>) {
+						value = piece == "true" || piece == "1";
+					}
+					else {
+						value = piece;
+					}
+					if (code == Code::NONE) code = check(value, piece);
+					if (code != Code::NONE) {
+						culprit = piece;
+						return false;
+					}
+					*out++ = value;
+					return true;
+				});
+				if (!complete) return code;
+			}
+			return Code::NONE;
+		}
+
+		/**
+		 * @brief Parses one list element of a numeric type, honouring DURATION and SIZE units.
+		 */
+		template<typename T>
+		std::optional<T> parse_element(std::string_view piece, const char* limit = nullptr) const
+		{
+			if constexpr (std::is_same_v<T, int>) return detail::parse_int(piece, limit);
+			else if constexpr (std::is_same_v<T, int64_t>) {
+				return type_ == ArgType::DURATION ? detail::parse_duration(piece) : detail::parse_number<int64_t>(piece);
+			}
+			else if constexpr (std::is_same_v<T, uint64_t>) {
+				return type_ == ArgType::SIZE ? detail::parse_size(piece) : detail::parse_number<uint64_t>(piece);
+			}
+			else return detail::parse_number<T>(piece);
+		}
+
+		/**
+		 * @brief The convert_elements() fast path for numeric lists without choices or a validator.
+		 */
+		template<typename T>
+		Code convert_numbers(std::span<const std::string_view> tokens, T* out, std::string_view& culprit) const
+		{
+			// The bounds become a plain range of the element type so the loop compares unconditionally.
+			using Limit = std::conditional_t<std::is_floating_point_v<T>, double, T>;
+			Limit low, high;
+			bool in_range = detail::range_within(min_value_, max_value_, low, high);
+			T* const first = out;
+
+			for (std::string_view token : tokens) {
+				const char* limit = token.data() + token.size();
+				const bool complete = detail::for_each_piece(token, delimiter_, [&](std::string_view piece) {
+					auto number = parse_element<T>(piece, limit);
+					if (!number) [[unlikely]] {
+						culprit = piece;
+						return false;
+					}
+					// Written so NaN passes, as it does in check().
+					in_range &= !(*number < low) && !(*number > high);
+					*out++ = *number;
+					return true;
+				});
+				if (!complete) return number_error<T>(culprit);
+			}
+
+			if (!in_range) {
+				// Rare path: find the first offending value and the piece it came from.
+				const T* bad = std::find_if(first, out, [&](T value) { return out_of_range(value) != Code::NONE; });
+				if (bad == out) return Code::NONE;
+				size_t skip = static_cast<size_t>(bad - first);
+				for (std::string_view token : tokens) {
+					const bool found = !detail::for_each_piece(token, delimiter_, [&](std::string_view piece) {
+						culprit = piece;
+						return skip-- != 0;
+					});
+					if (found) break;
+				}
+				return out_of_range(*bad);
+			}
+			return Code::NONE;
+		}
+
+		/**
+		 * @brief BELOW_MINIMUM or ABOVE_MAXIMUM if `value` is outside the bounds, otherwise NONE.
+		 */
+		template<typename T>
+		Code out_of_range(T value) const
+		{
+			if (min_value_ && detail::below(value, *min_value_)) return Code::BELOW_MINIMUM;
+			if (max_value_ && detail::above(value, *max_value_)) return Code::ABOVE_MAXIMUM;
+			return Code::NONE;
+		}
+
+		/**
+		 * @brief A bound as it appears in error messages, with the unit of a DURATION or SIZE argument.
+		 */
+		std::string format_bound(const std::optional<detail::Bound>& bound) const
+		{
+			if (!bound) return "0";
+			return std::visit([&](auto limit) -> std::string {
+				using B = decltype(limit);
+				if constexpr (std::is_floating_point_v<B>) {
+					char buffer[32];
+					auto result = std::to_chars(buffer, buffer + sizeof(buffer), limit);
+					return std::string(buffer, result.ptr);
+				}
+				else {
+					if (type_ == ArgType::DURATION && std::in_range<int64_t>(limit)) return detail::format_duration(static_cast<int64_t>(limit));
+					if (type_ == ArgType::SIZE && std::cmp_greater_equal(limit, 0)) return detail::format_size(static_cast<uint64_t>(limit));
+					return std::to_string(limit);
+				}
+			}, *bound);
+		}
+
+		/**
+		 * @brief Converts a raw string to a value of the given type, without validation.
+		 * @param value_str The raw value.
+		 * @param type The target type.
+		 * @return The converted value.
+		 * @throws ArgumentError if an INT or FLOAT value does not parse.
+		 */
+		static Value convert_value(std::string_view value_str, ArgType type)
+		{
+			return detail::to_value(convert_value_view(value_str, type));
+		}
+
+		/**
+		 * @brief Converts a raw string to a value of the given type, without validation or copies.
+		 *
+		 * Numbers are parsed with std::from_chars, so a non-numeric AUTO value costs
+		 * a few comparisons instead of thrown exceptions. A string result is a view
+		 * into `value_str`.
+		 *
+		 * @param value_str The raw value.
+		 * @param type The target type.
+		 * @return The converted value.
+		 * @throws ArgumentError if an INT or FLOAT value does not parse.
+		 */
+		static ValueView convert_value_view(std::string_view value_str, ArgType type)
+		{
+			ValueView value;
+			const Code code = try_convert_value(value_str, type, value);
+			if (code != Code::NONE) throw ArgumentError(describe_value(code, value_str));
+			return value;
+		}
+
+		/**
+		 * @brief Non-throwing convert_value_view().
+		 * @return Code::NONE, or MISSING_INTEGER, INVALID_INTEGER, INVALID_FLOAT, INVALID_DURATION or INVALID_SIZE.
+		 */
+		static Code try_convert_value(std::string_view value_str, ArgType type, ValueView& out)
+		{
+			switch (type)
+			{
+				case ArgType::INT: {
+					if (value_str.empty()) return Code::MISSING_INTEGER;
+					auto number = detail::parse_number<int>(value_str);
+					if (!number) return Code::INVALID_INTEGER;
+					out = *number;
+					return Code::NONE;
+				}
+				case ArgType::FLOAT: {
+					auto number = detail::parse_number<float>(value_str);
+					if (!number) return Code::INVALID_FLOAT;
+					out = *number;
+					return Code::NONE;
+				}
+				case ArgType::INT64: {
+					if (value_str.empty()) return Code::MISSING_INTEGER;
+					auto number = detail::parse_number<int64_t>(value_str);
+					if (!number) return Code::INVALID_INTEGER;
+					out = *number;
+					return Code::NONE;
+				}
+				case ArgType::UINT64: {
+					if (value_str.empty()) return Code::MISSING_INTEGER;
+					auto number = detail::parse_number<uint64_t>(value_str);
+					if (!number) return Code::INVALID_INTEGER;
+					out = *number;
+					return Code::NONE;
+				}
+				case ArgType::DOUBLE: {
+					auto number = detail::parse_number<double>(value_str);
+					if (!number) return Code::INVALID_FLOAT;
+					out = *number;
+					return Code::NONE;
+				}
+				case ArgType::DURATION: {
+					auto ns = detail::parse_duration(value_str);
+					if (!ns) return Code::INVALID_DURATION;
+					out = *ns;
+					return Code::NONE;
+				}
+				case ArgType::SIZE: {
+					auto bytes = detail::parse_size(value_str);
+					if (!bytes) return Code::INVALID_SIZE;
+					out = *bytes;
+					return Code::NONE;
+				}
+				case ArgType::BOOL: out = (value_str == "true" || value_str == "1"); return Code::NONE;
+				case ArgType::STRING: out = value_str; return Code::NONE;
+				case ArgType::AUTO: {
+					if (value_str == "true" || value_str == "false" ||
+						value_str == "1" || value_str == "0") {
+						out = value_str == "true" || value_str == "1";
+						return Code::NONE;
+					}
+					if (detail::may_be_number(value_str)) {
+						if (auto number = detail::parse_number<int>(value_str)) {
+							out = *number;
+							return Code::NONE;
+						}
+						if (auto number = detail::parse_number<float>(value_str)) {
+							out = *number;
+							return Code::NONE;
+						}
+					}
+					out = value_str;
+					return Code::NONE;
+				}
+				default: out = value_str; return Code::NONE;
+			}
+		}
+
+		/**
+		 * @brief The error text for a conversion code that needs no argument settings.
+		 */
+		static std::string describe_value(Code code, std::string_view value_str)
+		{
+			switch (code)
+			{
+				case Code::MISSING_INTEGER: return "Missing integer value";
+				case Code::INVALID_INTEGER: return "Invalid integer value: " + std::string(value_str);
+				case Code::INVALID_FLOAT: return "Invalid float value: " + std::string(value_str);
+				case Code::INVALID_DURATION: return "Invalid duration value: " + std::string(value_str) + " (expected e.g. 500ms, 30s, 1h30m)";
+				case Code::INVALID_SIZE: return "Invalid size value: " + std::string(value_str) + " (expected e.g. 4096, 512KiB, 64GiB)";
+				default: return "Validation failed.";
+			}
+		}
+
+		/**
+		 * @brief Applies range checks, choices and the custom validator to a converted value.
+		 */
+		template<typename T>
+		Code check(const T& value, std::string_view value_str) const
+		{
+			if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+				if (type_ != ArgType::AUTO && type_ != ArgType::STRING) {
+					if (const Code code = out_of_range(value); code != Code::NONE) return code;
+				}
+			}
+			if (type_ != ArgType::INT && !choices_.empty() && !find_choice(value_str)) return Code::INVALID_CHOICE;
+			return check_custom(ValueView(value), value_str);
+		}
+
+		Code check_custom(const ValueView& value, std::string_view value_str) const
+		{
+			if (custom_validator_ && !custom_validator_(value, value_str)) return Code::VALIDATION_FAILED;
+			return Code::NONE;
+		}
+
+		/**
+		 * @brief Position of `value` among the choices.
+		 *
+		 * Uses the hashed set built by freeze() when available, a linear scan otherwise.
+		 *
+		 * @return std::nullopt if `value` is not one of them.
+		 */
+		std::optional<size_t> find_choice(std::string_view value) const
+		{
+			if (choice_set_) return choice_set_->index.find(value);
+			auto it = std::find(choices_.begin(), choices_.end(), value);
+			if (it == choices_.end()) return std::nullopt;
+			return static_cast<size_t>(it - choices_.begin());
+		}
+
+		/**
+		 * @brief Precomputes the choice lookup and its error text; called when the parser compiles.
+		 * @throws ArgumentError if a choice is listed twice.
+		 */
+		void freeze()
+		{
+			if (choices_.empty()) {
+				choice_set_.reset();
+				return;
+			}
+			std::vector<detail::NameIndex::Entry> names;
+			names.reserve(choices_.size());
+			for (size_t i = 0; i < choices_.size(); ++i) names.push_back({ choices_[i], i });
+			choice_set_ = std::make_shared<const detail::ChoiceSet>(names, "Invalid choice. Options: " + join_strings(choices_, ", "));
+		}
+
+		/**
+		 * @brief Feeds every setting that affects parsed values into `hash`.
+		 *
+		 * Help text is left out; a custom validator only counts by its presence
+		 * and message, since a callable cannot be hashed.
+		 */
+		void hash_schema(detail::Hasher& hash) const
+		{
+			hash.add(name());
+			const auto aliases = this->aliases();
+			hash.add(aliases.size());
+			for (std::string_view alias : aliases) hash.add(alias);
+			hash.add(static_cast<uint64_t>(type_));
+			hash.add(default_value_.index());
+			std::visit([&](const auto& value) {
+				using T = std::decay_t<decltype(value)>;
+				if constexpr (std::is_same_v<T, std::string>) hash.add(std::string_view(value));
+				else if constexpr (std::is_same_v<T, float>) hash.add(std::bit_cast<uint32_t>(value));
+				else if constexpr (std::is_same_v<T, double>) hash.add(std::bit_cast<uint64_t>(value));
+				else hash.add(static_cast<uint64_t>(value));
+			}, default_value_);
+			hash.add((uint64_t(required_) << 0) | (uint64_t(is_flag_) << 1) | (uint64_t(append_) << 2) |
+				(uint64_t(bool(custom_validator_)) << 3) | (uint64_t(enum_tag_ != nullptr) << 4) |
+				(uint64_t(min_value_.has_value()) << 5) | (uint64_t(max_value_.has_value()) << 6) |
+				(uint64_t(env_var_.has_value()) << 7) | (uint64_t(static_cast<unsigned char>(delimiter_)) << 8));
+			for (const auto& bound : { min_value_, max_value_ }) {
+				if (!bound) continue;
+				hash.add(bound->index());
+				std::visit([&](auto limit) { hash.add(std::bit_cast<uint64_t>(limit)); }, *bound);
+			}
+			hash.add(env_var_.value_or(std::string()));
+			hash.add(custom_validator_error_.value_or(std::string()));
+			hash.add(nargs_min_);
+			hash.add(nargs_max_);
+			hash.add(choices_.size());
+			for (const auto& choice : choices_) hash.add(choice);
+			for (int value : choice_values_) hash.add(static_cast<uint64_t>(static_cast<uint32_t>(value)));
+		}
+
+		/**
+		 * @brief The conversion code for a list element that did not parse as T.
+		 */
+		template<typename T>
+		Code number_error(std::string_view piece) const
+		{
+			if constexpr (std::is_floating_point_v<T>) return Code::INVALID_FLOAT;
+			else if (type_ == ArgType::DURATION) return Code::INVALID_DURATION;
+			else if (type_ == ArgType::SIZE) return Code::INVALID_SIZE;
+			else return piece.empty() ? Code::MISSING_INTEGER : Code::INVALID_INTEGER;
+		}
+
+		// Utility function:
+		/**
+		 * @brief Joins a vector of strings with a delimiter.
+		 * @param vec The vector of strings.
+		 * @param delim The delimiter string.
+		 * @return A concatenated string.
+		 */
+		static std::string join_strings(const std::vector<std::string>& vec, const std::string& delim)
+		{
+			std::string result;
+			for (size_t i = 0; i < vec.size(); ++i) {
+				if (i != 0) result += delim;
+				result += vec[i];
+			}
+			return result;
+		}
+
+		friend class ArgumentParser;
+	};
+
+	namespace detail
+	{
+		/**
+		 * @brief Maps a stored type to the type handed out by ParsedArgs::operator[].
+		 *
+		 * Strings are returned as a view so access never copies.
+		 */
+		template<typename T>
+		using access_t = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+
+		/**
+		 * @brief The ValueView alternative holding a T; enumerators are stored as int.
+		 */
+		template<typename T>
+		using stored_t = std::conditional_t<std::is_enum_v<T>, int, std::conditional_t<is_duration_v<T>, int64_t, access_t<T>>>;
+
+		/**
+		 * @brief Turns a stored alternative back into T; durations are stored as nanoseconds.
+		 */
+		template<typename T>
+		access_t<T> from_stored(const stored_t<T>& value)
+		{
+			if constexpr (is_duration_v<T>) return std::chrono::duration_cast<T>(std::chrono::nanoseconds(value));
+			else return static_cast<access_t<T>>(value);
+		}
+
+		/**
+		 * @brief Builds the name lookup of a schema from every name and alias.
+		 *
+		 * The index views the names where `table` stores them and shares its
+		 * ownership, so no name is copied.
+		 *
+		 * @throws ArgumentError if a name or alias is used twice.
+		 */
+		inline std::shared_ptr<const NameIndex> index_arguments(const std::vector<Argument>& args,
+			std::shared_ptr<const NameTable> table)
+		{
+			std::vector<NameIndex::Entry> names;
+			names.reserve(args.size());
+			for (size_t i = 0; i < args.size(); ++i) {
+				names.push_back({ args[i].name(), i });
+				for (std::string_view alias : args[i].aliases()) names.push_back({ alias, i });
+			}
+			return std::make_shared<const NameIndex>(names, "Duplicate argument or alias: ", std::move(table));
+		}
+
+		template<typename T>
+		constexpr bool matches_type(Argument::ArgType type)
+		{
+			if constexpr (std::is_same_v<T, int>) return type == Argument::ArgType::INT;
+			else if constexpr (std::is_same_v<T, float>) return type == Argument::ArgType::FLOAT;
+			else if constexpr (std::is_same_v<T, std::string>) return type == Argument::ArgType::STRING;
+			else if constexpr (std::is_same_v<T, bool>) return type == Argument::ArgType::BOOL;
+			else if constexpr (std::is_same_v<T, int64_t>) return type == Argument::ArgType::INT64 || type == Argument::ArgType::DURATION;
+			else if constexpr (std::is_same_v<T, uint64_t>) return type == Argument::ArgType::UINT64 || type == Argument::ArgType::SIZE;
+			else if constexpr (std::is_same_v<T, double>) return type == Argument::ArgType::DOUBLE;
+			else if constexpr (is_duration_v<T>) return type == Argument::ArgType::DURATION;
+			else return false;
+		}
+
+		/**
+		 * @brief Fixed-size header of a serialized ParsedArgs.
+		 *
+		 * It is followed by the value block as it was in memory, then the name of
+		 * the selected subcommand and that subcommand's own snapshot.
+		 */
+		struct SnapshotHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t layout;
+			uint64_t schema_hash;
+			uint64_t input_hash;
+			uint64_t checksum;
+			uint64_t base;
+			uint64_t count;
+			uint64_t block_size;
+			uint64_t lists_offset;
+			uint64_t strings_offset;
+			uint64_t cursor_offset;
+			uint64_t command_name_size;
+			uint64_t command_size;
+		};
+
+		inline constexpr char snapshot_magic[8] = { 'A', 'R', 'G', 'P', 'S', 'N', 'A', 'P' };
+		inline constexpr uint32_t snapshot_version = 1;
+
+		// Snapshots hold raw values, so they are only read back by a build with the same layout.
+		inline constexpr uint32_t snapshot_layout = static_cast<uint32_t>(sizeof(ValueView) | (alignof(ValueView) << 8) |
+			(sizeof(std::string_view) << 16) | (alignof(std::max_align_t) << 24));
+
+		/**
+		 * @brief Replaces `path` with `data` by writing a temporary file and renaming it.
+		 * @return False if the file could not be written.
+		 */
+		inline bool write_file(const std::string& path, std::string_view data)
+		{
+#if ARGPARSE_HAS_MMAP
+			const std::string temp = path + "." + std::to_string(::getpid()) + ".tmp";
+#else
+			const std::string temp = path + ".tmp";
+#endif
+			std::FILE* out = std::fopen(temp.c_str(), "wb");
+			if (!out) return false;
+			const bool written = std::fwrite(data.data(), 1, data.size(), out) == data.size();
+			bool ok = std::fclose(out) == 0 && written;
+#if !ARGPARSE_HAS_MMAP
+			if (ok) std::remove(path.c_str());
+#endif
+			ok = ok && std::rename(temp.c_str(), path.c_str()) == 0;
+			if (!ok) std::remove(temp.c_str());
+			return ok;
+		}
+	}
+
+	/**
+	 * @brief Typed handle to an argument for O(1) access into ParsedArgs.
+	 *
+	 * Obtained by assigning a configured argument to a key of the matching type:
+	 * @code
+	 * argparse::ArgKey<int> count = parser.add_argument("count").type_int();
+	 * auto args = parser.parse_args(argc, argv);
+	 * int n = args[count];
+	 * @endcode
+	 *
+	 * @tparam T The stored type (int, float, std::string, bool, int64_t, uint64_t, double),
+	 *         a std::chrono::duration for a DURATION argument, or the enumeration given to choices_enum().
+	 */
+	template<typename T>
+	class ArgKey
+	{
+		size_t index_;
+
+	public:
+		/**
+		 * @brief Creates a key for an argument.
+		 * @param arg The argument, already configured with its type.
+		 * @throws ArgumentError if the argument does not store values of type T, or is a list (use ListKey).
+		 */
+		ArgKey(const Argument& arg) : index_(arg.index())
+		{
+			if (arg.is_list()) {
+				throw ArgumentError("Argument is a list, use ListKey: --" + std::string(arg.name()));
+			}
+			bool type_ok;
+			if constexpr (std::is_enum_v<T>) {
+				type_ok = arg.template is_enum<T>();
+			}
+			else {
+				using Owned = std::conditional_t<detail::is_duration_v<T>, int64_t, T>;
+				type_ok = (detail::matches_type<T>(arg.type()) || (std::is_same_v<T, bool> && arg.is_flag()))
+					&& std::holds_alternative<Owned>(arg.default_value());
+			}
+			if (!type_ok) {
+				throw ArgumentError("Argument type does not match key type: --" + std::string(arg.name()));
+			}
+		}
+
+		size_t index() const
+		{
+			return index_;
+		}
+	};
+
+	/**
+	 * @brief Typed handle to a list-valued argument for O(1) access into ParsedArgs.
+	 *
+	 * @code
+	 * argparse::ListKey<int> ids = parser.add_argument("ids").type_int().delimiter(',');
+	 * auto args = parser.parse_args(argc, argv);
+	 * for (int id : args[ids]) { ... }
+	 * @endcode
+	 *
+	 * @tparam T The element type (int, float, bool, int64_t, uint64_t, double, std::string_view).
+	 */
+	template<typename T>
+	class ListKey
+	{
+		size_t index_;
+
+	public:
+		/**
+		 * @brief Creates a key for a list argument.
+		 * @param arg The argument, already configured as a list.
+		 * @throws ArgumentError if the argument is not a list of T.
+		 */
+		ListKey(const Argument& arg) : index_(arg.index())
+		{
+			if (!arg.is_list() || arg.element_type() != detail::element_type_of<T>()) {
+				throw ArgumentError("Argument type does not match key type: --" + std::string(arg.name()));
+			}
+		}
+
+		size_t index() const
+		{
+			return index_;
+		}
+	};
+
+	/**
+	 * @brief The values produced by one parse.
+	 *
+	 * All values, every list's elements and the bytes of every string live in
+	 * a single block obtained from one `std::pmr::memory_resource` allocation
+	 * and released all at once, so a request handler can hand in a per-request
+	 * arena. Lists are stored as contiguous typed arrays.
+	 *
+	 * Results of a lazy parse (see ArgumentParser::lazy()) hold some values as
+	 * their raw text, converted on first read. Until validate_all() has run
+	 * they must not be read from several threads at once, and the parser that
+	 * produced them must stay alive and unmodified.
+	 */
+	class ParsedArgs
+	{
+		std::pmr::memory_resource* resource_ = nullptr;
+		void* block_ = nullptr;
+		size_t block_size_ = 0;
+		detail::ValueView* values_ = nullptr;
+		size_t size_ = 0;
+		char* lists_ = nullptr;
+		char* strings_ = nullptr;
+		char* cursor_ = nullptr;
+		std::shared_ptr<const detail::NameIndex> index_;
+
+		// One bit per value still held as raw text, and the parser that converts it; null when there is none.
+		uint64_t* pending_ = nullptr;
+		const ArgumentParser* parser_ = nullptr;
+
+		// The selected subcommand's name and values; shared, since it is never modified.
+		using Command = std::pair<std::pmr::string, ParsedArgs>;
+		std::shared_ptr<const Command> command_;
+
+		static constexpr size_t list_align = alignof(std::max_align_t);
+
+		ParsedArgs(std::shared_ptr<const detail::NameIndex> index, size_t count, size_t list_bytes, size_t string_bytes,
+			std::pmr::memory_resource* resource)
+			: resource_(resource), index_(std::move(index))
+		{
+			allocate(count, list_bytes, string_bytes);
+		}
+
+		static size_t element_size(detail::ElementType type)
+		{
+			switch (type) {
+				case detail::ElementType::INT: return sizeof(int);
+				case detail::ElementType::FLOAT: return sizeof(float);
+				case detail::ElementType::BOOL: return sizeof(bool);
+				case detail::ElementType::INT64: return sizeof(int64_t);
+				case detail::ElementType::UINT64: return sizeof(uint64_t);
+				case detail::ElementType::DOUBLE: return sizeof(double);
+				default: return sizeof(std::string_view);
+			}
+		}
+
+		/**
+		 * @brief Bytes a list of `count` elements occupies in the block, padded for alignment.
+		 */
+		static size_t list_bytes(detail::ElementType type, size_t count)
+		{
+			return (element_size(type) * count + list_align - 1) / list_align * list_align;
+		}
+
+		/**
+		 * @brief Bytes the values of `count` arguments occupy at the start of the block.
+		 */
+		static size_t value_bytes(size_t count)
+		{
+			return (count * sizeof(detail::ValueView) + list_align - 1) / list_align * list_align;
+		}
+
+		void allocate(size_t count, size_t list_bytes, size_t string_bytes)
+		{
+			static_assert(std::is_trivially_copyable_v<detail::ValueView>);
+			const size_t value_bytes = ParsedArgs::value_bytes(count);
+			block_size_ = value_bytes + list_bytes + string_bytes;
+			if (block_size_ == 0) return;
+			block_ = resource_->allocate(block_size_, list_align);
+			values_ = static_cast<detail::ValueView*>(block_);
+			size_ = count;
+			lists_ = static_cast<char*>(block_) + value_bytes;
+			strings_ = cursor_ = lists_ + list_bytes;
+			std::uninitialized_default_construct_n(values_, count);
+		}
+
+		std::string_view copy_string(std::string_view text)
+		{
+			if (!text.empty()) std::memcpy(cursor_, text.data(), text.size());
+			const std::string_view stored(cursor_, text.size());
+			cursor_ += text.size();
+			return stored;
+		}
+
+		/**
+		 * @brief Stores a value, copying string contents into the block.
+		 *
+		 * An empty list points at the list cursor, as store_list() would leave it.
+		 */
+		void store(size_t index, const detail::ValueView& value)
+		{
+			if (auto text = std::get_if<std::string_view>(&value)) {
+				values_[index] = copy_string(*text);
+			}
+			else if (auto list = std::get_if<detail::ListView>(&value)) {
+				values_[index] = detail::ListView{ lists_, 0, list->type };
+			}
+			else {
+				values_[index] = value;
+			}
+		}
+
+		/**
+		 * @brief Converts a list argument's values straight into the block.
+		 * @return Code::NONE, or why the element in `culprit` was rejected.
+		 */
+		ParseError::Code store_list(size_t index, const Argument& arg, std::span<const std::string_view> tokens,
+			size_t count, std::string_view& culprit)
+		{
+			ARGPARSE_PHASE(CONVERT);
+			detail::ListView list;
+			list.type = arg.element_type();
+			list.size = static_cast<uint32_t>(count);
+			list.data = lists_;
+
+			ParseError::Code code = ParseError::Code::NONE;
+			switch (list.type) {
+				case detail::ElementType::INT: code = arg.convert_elements(tokens, reinterpret_cast<int*>(lists_), culprit); break;
+				case detail::ElementType::FLOAT: code = arg.convert_elements(tokens, reinterpret_cast<float*>(lists_), culprit); break;
+				case detail::ElementType::BOOL: code = arg.convert_elements(tokens, reinterpret_cast<bool*>(lists_), culprit); break;
+				case detail::ElementType::INT64: code = arg.convert_elements(tokens, reinterpret_cast<int64_t*>(lists_), culprit); break;
+				case detail::ElementType::UINT64: code = arg.convert_elements(tokens, reinterpret_cast<uint64_t*>(lists_), culprit); break;
+				case detail::ElementType::DOUBLE: code = arg.convert_elements(tokens, reinterpret_cast<double*>(lists_), culprit); break;
+				case detail::ElementType::STRING: {
+					auto* out = ::new (static_cast<void*>(lists_)) std::string_view[count];
+					code = arg.convert_elements(tokens, out, culprit);
+					if (code == ParseError::Code::NONE) {
+						for (size_t i = 0; i < count; ++i) out[i] = copy_string(out[i]);
+					}
+					break;
+				}
+			}
+			if (code != ParseError::Code::NONE) return code;
+
+			lists_ += list_bytes(list.type, count);
+			values_[index] = list;
+			return code;
+		}
+
+		/**
+		 * @brief Records the subcommand that parsed the rest of the command line.
+		 */
+		void set_command(std::string_view name, ParsedArgs args)
+		{
+			std::pmr::polymorphic_allocator<Command> alloc(resource_ ? resource_ : args.resource_);
+			command_ = std::allocate_shared<Command>(alloc, std::pmr::string(name, alloc), std::move(args));
+		}
+
+		/**
+		 * @brief Repoints every view at the same offset inside this block after a copy.
+		 */
+		void rebase(const void* old_block)
+		{
+			auto move_ptr = [&](const void* ptr) {
+				return static_cast<const char*>(block_) + (static_cast<const char*>(ptr) - static_cast<const char*>(old_block));
+			};
+			for (size_t i = 0; i < size_; ++i) {
+				if (auto text = std::get_if<std::string_view>(&values_[i])) {
+					*text = std::string_view(move_ptr(text->data()), text->size());
+				}
+				else if (auto list = std::get_if<detail::ListView>(&values_[i])) {
+					list->data = move_ptr(list->data);
+					if (list->type == detail::ElementType::STRING) {
+						auto* items = static_cast<std::string_view*>(const_cast<void*>(list->data));
+						for (uint32_t j = 0; j < list->size; ++j) {
+							items[j] = std::string_view(move_ptr(items[j].data()), items[j].size());
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Fills this freshly allocated block from a snapshot and repoints its views.
+		 * @param data The block bytes as they were written.
+		 * @param old_base Address the block had in the process that wrote it.
+		 * @return False if a value or view does not fit the block, i.e. the data is damaged.
+		 */
+		bool load_block(const char* data, uintptr_t old_base)
+		{
+			if (block_size_) std::memcpy(block_, data, block_size_);
+			auto move_ptr = [&](const void* ptr, size_t bytes, const char*& out) {
+				const uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - old_base;
+				if (offset > block_size_ || bytes > block_size_ - offset) return false;
+				out = static_cast<const char*>(block_) + offset;
+				return true;
+			};
+			for (size_t i = 0; i < size_; ++i) {
+				if (values_[i].index() >= std::variant_size_v<detail::ValueView>) return false;
+				if (auto text = std::get_if<std::string_view>(&values_[i])) {
+					const char* moved;
+					if (!move_ptr(text->data(), text->size(), moved)) return false;
+					*text = std::string_view(moved, text->size());
+				}
+				else if (auto list = std::get_if<detail::ListView>(&values_[i])) {
+					if (list->type > detail::ElementType::DOUBLE) return false;
+					const char* moved;
+					if (!move_ptr(list->data, element_size(list->type) * list->size, moved)) return false;
+					list->data = moved;
+					if (list->type == detail::ElementType::STRING) {
+						auto* items = reinterpret_cast<std::string_view*>(const_cast<char*>(moved));
+						for (uint32_t j = 0; j < list->size; ++j) {
+							const char* item;
+							if (!move_ptr(items[j].data(), items[j].size(), item)) return false;
+							items[j] = std::string_view(item, items[j].size());
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		size_t pending_words() const
+		{
+			return (size_ + 63) / 64;
+		}
+
+		bool is_pending(size_t index) const
+		{
+			return (pending_[index / 64] >> (index % 64)) & 1;
+		}
+
+		/**
+		 * @brief Marks a stored value as raw text that `parser` converts when it is read.
+		 */
+		void defer(size_t index, const ArgumentParser* parser)
+		{
+			if (!pending_) {
+				pending_ = static_cast<uint64_t*>(resource_->allocate(pending_words() * sizeof(uint64_t), alignof(uint64_t)));
+				std::fill_n(pending_, pending_words(), 0);
+			}
+			parser_ = parser;
+			pending_[index / 64] |= uint64_t(1) << (index % 64);
+		}
+
+		/**
+		 * @brief Converts and validates a deferred value in place.
+		 * @return The reason the value was rejected, if it was; it then stays deferred.
+		 */
+		std::optional<ParseError> try_convert(size_t index) const;
+
+		/**
+		 * @brief Converts and validates a deferred value in place.
+		 * @throws ArgumentError if the value is rejected; it then stays deferred.
+		 */
+		void convert(size_t index) const
+		{
+			if (auto error = try_convert(index)) throw ArgumentError(error->message());
+		}
+
+		const detail::ValueView& slot(std::string_view name) const
+		{
+			auto pos = index_ ? index_->find(detail::strip_dashes(name)) : std::nullopt;
+			if (!pos) {
+				throw std::out_of_range("Unknown argument: " + std::string(name));
+			}
+			if (pending_ && is_pending(*pos)) convert(*pos);
+			return values_[*pos];
+		}
+
+	public:
+		ParsedArgs() = default;
+
+		ParsedArgs(const ParsedArgs& other)
+			: resource_(other.resource_), index_(other.index_), parser_(other.parser_), command_(other.command_)
+		{
+			if (!other.block_) return;
+			block_size_ = other.block_size_;
+			block_ = resource_->allocate(block_size_, list_align);
+			std::memcpy(block_, other.block_, block_size_);
+			auto offset = [&](const char* ptr) { return static_cast<char*>(block_) + (ptr - static_cast<const char*>(other.block_)); };
+			values_ = static_cast<detail::ValueView*>(block_);
+			size_ = other.size_;
+			lists_ = offset(other.lists_);
+			strings_ = offset(other.strings_);
+			cursor_ = offset(other.cursor_);
+			rebase(other.block_);
+			if (other.pending_) {
+				pending_ = static_cast<uint64_t*>(resource_->allocate(pending_words() * sizeof(uint64_t), alignof(uint64_t)));
+				std::copy_n(other.pending_, pending_words(), pending_);
+			}
+		}
+
+		ParsedArgs(ParsedArgs&& other) noexcept
+		{
+			swap(other);
+		}
+
+		ParsedArgs& operator=(ParsedArgs other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+
+		~ParsedArgs()
+		{
+			if (pending_) resource_->deallocate(pending_, pending_words() * sizeof(uint64_t), alignof(uint64_t));
+			if (block_) resource_->deallocate(block_, block_size_, list_align);
+		}
+
+		void swap(ParsedArgs& other) noexcept
+		{
+			std::swap(resource_, other.resource_);
+			std::swap(block_, other.block_);
+			std::swap(block_size_, other.block_size_);
+			std::swap(values_, other.values_);
+			std::swap(size_, other.size_);
+			std::swap(lists_, other.lists_);
+			std::swap(strings_, other.strings_);
+			std::swap(cursor_, other.cursor_);
+			std::swap(index_, other.index_);
+			std::swap(pending_, other.pending_);
+			std::swap(parser_, other.parser_);
+			std::swap(command_, other.command_);
+		}
+
+		/**
+		 * @brief Retrieves the value of an argument by name.
+		 * @tparam T The stored type (int, float, std::string, bool, int64_t, uint64_t, double),
+		 *         std::string_view to read a string without copying it, a
+		 *         std::chrono::duration for a DURATION argument, or the
+		 *         enumeration of a choices_enum() argument.
+		 * @param name The argument name or alias, with or without leading dashes.
+		 * @return The parsed value.
+		 * @throws std::out_of_range if no argument with that name exists.
+		 * @throws ArgumentError if a lazily parsed value is rejected on this first read.
+		 */
+		template<typename T>
+		T get(std::string_view name) const;
+
+		/**
+		 * @brief Retrieves the value of an argument through its typed key.
+		 *
+		 * The key was type-checked when it was created, so this is a plain array
+		 * access with no name lookup and no variant type check.
+		 *
+		 * @param key Key obtained from the parser that produced these results.
+		 * @return The parsed value; strings are returned as a view.
+		 * @throws ArgumentError if a lazily parsed value is rejected on this first read.
+		 */
+		template<typename T>
+		detail::access_t<T> operator[](ArgKey<T> key) const
+		{
+			if (pending_ && is_pending(key.index())) [[unlikely]] convert(key.index());
+			// Dereferencing lets the compiler assume the alternative matches and drop the check.
+			return detail::from_stored<T>(*std::get_if<detail::stored_t<T>>(&values_[key.index()]));
+		}
+
+		/**
+		 * @brief Retrieves the elements of a list argument by name.
+		 * @tparam T The element type (int, float, bool, int64_t, uint64_t, double, std::string_view);
+		 *         DURATION lists hold int64_t nanoseconds and SIZE lists uint64_t bytes.
+		 * @param name The argument name or alias, with or without leading dashes.
+		 * @return A view of the contiguous elements, valid as long as this object.
+		 * @throws std::out_of_range if no argument with that name exists.
+		 * @throws std::bad_variant_access if the argument is not a list of T.
+		 */
+		template<typename T>
+		std::span<const T> get_list(std::string_view name) const;
+
+		/**
+		 * @brief Retrieves the elements of a list argument through its typed key.
+		 * @param key Key obtained from the parser that produced these results.
+		 * @return A view of the contiguous elements, valid as long as this object.
+		 */
+		template<typename T>
+		std::span<const T> operator[](ListKey<T> key) const
+		{
+			const auto& list = *std::get_if<detail::ListView>(&values_[key.index()]);
+			return { static_cast<const T*>(list.data), list.size };
+		}
+
+		/**
+		 * @brief Converts and validates every value a lazy parse left as text.
+		 *
+		 * Reports what an eager parse would have rejected, including in the
+		 * selected subcommand's values. Afterwards no read converts anything,
+		 * so the results may be shared between threads. Does nothing for the
+		 * results of an eager parse.
+		 *
+		 * @throws ArgumentError for the first value that is rejected.
+		 */
+		void validate_all() const
+		{
+			if (auto error = try_validate_all()) throw ArgumentError(error->message());
+		}
+
+		/**
+		 * @brief validate_all() without exceptions.
+		 * @return The first rejected value, with the code, argument and text an
+		 *         eager parse would report but no token position; std::nullopt if all are valid.
+		 */
+		std::optional<ParseError> try_validate_all() const
+		{
+			for (size_t i = 0; pending_ && i < size_; ++i) {
+				if (!is_pending(i)) continue;
+				if (auto error = try_convert(i)) return error;
+			}
+			return command_ ? command_->second.try_validate_all() : std::nullopt;
+		}
+
+		/**
+		 * @brief Name of the subcommand the command line selected, or empty if none was.
+		 */
+		std::string_view subcommand() const
+		{
+			return command_ ? std::string_view(command_->first) : std::string_view();
+		}
+
+		/**
+		 * @brief The values parsed by the selected subcommand's parser.
+		 * @throws std::out_of_range if no subcommand was selected.
+		 */
+		const ParsedArgs& subcommand_args() const
+		{
+			if (!command_) throw std::out_of_range("No subcommand was selected");
+			return command_->second;
+		}
+
+		/**
+		 * @brief Number of stored values, one per declared argument.
+		 */
+		size_t size() const
+		{
+			return size_;
+		}
+
+		/**
+		 * @brief The memory resource the values were allocated from.
+		 */
+		std::pmr::memory_resource* resource() const
+		{
+			return resource_;
+		}
+
+		friend class ArgumentParser;
+	};
+
+	/**
+	 * @brief Outcome of ArgumentParser::parse: parsed values, a help request, or an error.
+	 */
+	class ParseResult
+	{
+	public:
+		enum class Status { OK, HELP, ERROR };
+
+		Status status() const
+		{
+			return status_;
+		}
+
+		explicit operator bool() const
+		{
+			return status_ == Status::OK;
+		}
+
+		bool help_requested() const
+		{
+			return status_ == Status::HELP;
+		}
+
+		/**
+		 * @brief The parser whose help was requested, e.g. a subcommand's; null unless status() is HELP.
+		 *
+		 * The pointer stays valid as long as the top-level parser that produced this result.
+		 */
+		const ArgumentParser* help_parser() const
+		{
+			return help_for_;
+		}
+
+		/**
+		 * @brief The error message; empty unless status() is ERROR.
+		 *
+		 * Built from parse_error() on each call.
+		 */
+		std::string error() const
+		{
+			return status_ == Status::ERROR ? error_.message() : std::string();
+		}
+
+		/**
+		 * @brief The structured error; its code is NONE unless status() is ERROR.
+		 */
+		const ParseError& parse_error() const
+		{
+			return error_;
+		}
+
+		/**
+		 * @brief The parsed values; empty unless status() is OK.
+		 */
+		const ParsedArgs& args() const&
+		{
+			return args_;
+		}
+
+		ParsedArgs args()&&
+		{
+			return std::move(args_);
+		}
+
+	private:
+		Status status_ = Status::OK;
+		ParsedArgs args_;
+		ParseError error_;
+		const ArgumentParser* help_for_ = nullptr;
+
+		static ParseResult success(ParsedArgs args)
+		{
+			ParseResult result;
+			result.args_ = std::move(args);
+			return result;
+		}
+
+		static ParseResult help(const ArgumentParser* parser)
+		{
+			ParseResult result;
+			result.status_ = Status::HELP;
+			result.help_for_ = parser;
+			return result;
+		}
+
+		static ParseResult failure(ParseError error)
+		{
+			ParseResult result;
+			result.status_ = Status::ERROR;
+			result.error_ = std::move(error);
+			return result;
+		}
+
+		friend class ArgumentParser;
+	};
+
+	/**
+	 * @brief The values of many command lines parsed against one schema, stored column by column.
+	 *
+	 * Each argument has one contiguous column with a cell per command line
+	 * (row): the plain value for typed arguments, a string_view for strings,
+	 * a list view for lists, and the whole variant for AUTO arguments. String
+	 * and list contents live in arenas shared by all rows. Rows that failed
+	 * hold zeros and have an entry in errors(). A selected subcommand is
+	 * recorded by name only; parse those rows with the subcommand's parser to
+	 * get its values.
+	 */
+	class BatchResult
+	{
+	public:
+		/**
+		 * @brief Why one row was rejected.
+		 */
+		struct Failure
+		{
+			size_t row;
+			ParseError error;
+		};
+
+		/**
+		 * @brief Number of rows, one per command line.
+		 */
+		size_t size() const
+		{
+			return rows_;
+		}
+
+		/**
+		 * @brief The rejected rows, in row order; help requests count as Code::HELP_REQUESTED.
+		 */
+		std::span<const Failure> errors() const
+		{
+			return errors_;
+		}
+
+		/**
+		 * @brief Why a row was rejected, or null if it parsed.
+		 */
+		const ParseError* error(size_t row) const
+		{
+			auto it = std::lower_bound(errors_.begin(), errors_.end(), row, [](const Failure& f, size_t r) { return f.row < r; });
+			return it != errors_.end() && it->row == row ? &it->error : nullptr;
+		}
+
+		bool ok(size_t row) const
+		{
+			return error(row) == nullptr;
+		}
+
+		/**
+		 * @brief The column of an argument through its typed key.
+		 * @param key Key obtained from the parser that produced the batch.
+		 * @return One cell per row; durations are nanoseconds and enumerators int.
+		 * @throws std::bad_variant_access for an AUTO argument, whose cells have no single type.
+		 */
+		template<typename T>
+		std::span<const detail::stored_t<T>> operator[](ArgKey<T> key) const
+		{
+			return column<detail::stored_t<T>>(columns_[key.index()]);
+		}
+
+		/**
+		 * @brief The column of an argument by name.
+		 * @tparam T The cell type: int, float, std::string_view, bool, int64_t, uint64_t or double.
+		 * @param name The argument name or alias, with or without leading dashes.
+		 * @return One cell per row.
+		 * @throws std::out_of_range if no argument with that name exists.
+		 * @throws std::bad_variant_access if the cells are not T.
+		 */
+		template<typename T>
+		std::span<const T> column(std::string_view name) const
+		{
+			return column<T>(find(name));
+		}
+
+		/**
+		 * @brief One row's value of an argument, as ParsedArgs::get() would return it.
+		 * @throws std::out_of_range if no argument with that name exists.
+		 * @throws std::bad_variant_access if the argument does not hold a T.
+		 */
+		template<typename T>
+		T get(size_t row, std::string_view name) const
+		{
+			using Stored = detail::stored_t<T>;
+			const Column& col = find(name);
+			const Stored& stored = col.alternative == std::variant_npos
+				? std::get<Stored>(cells<detail::ValueView>(col)[row])
+				: column<Stored>(col)[row];
+			if constexpr (std::is_same_v<T, std::string>) return std::string(stored);
+			else if constexpr (std::is_enum_v<T>) return static_cast<T>(stored);
+			else return detail::from_stored<T>(stored);
+		}
+
+		/**
+		 * @brief One row's elements of a list argument by name.
+		 * @throws std::out_of_range if no argument with that name exists.
+		 * @throws std::bad_variant_access if the argument is not a list of T.
+		 */
+		template<typename T>
+		std::span<const T> get_list(size_t row, std::string_view name) const
+		{
+			const detail::ListView& list = column<detail::ListView>(find(name))[row];
+			if (list.type != detail::element_type_of<T>()) throw std::bad_variant_access();
+			return { static_cast<const T*>(list.data), list.size };
+		}
+
+		/**
+		 * @brief One row's elements of a list argument through its typed key.
+		 */
+		template<typename T>
+		std::span<const T> list(ListKey<T> key, size_t row) const
+		{
+			const detail::ListView& list = cells<detail::ListView>(columns_[key.index()])[row];
+			return { static_cast<const T*>(list.data), list.size };
+		}
+
+		/**
+		 * @brief The subcommand a row selected, or empty if it selected none.
+		 */
+		std::string_view subcommand(size_t row) const
+		{
+			return commands_.empty() ? std::string_view() : commands_[row];
+		}
+
+	private:
+		struct Column
+		{
+			size_t alternative = std::variant_npos;  ///< The ValueView alternative of every cell; npos for whole variants.
+			size_t offset = 0;                       ///< First cell, in words of storage_.
+		};
+
+		size_t rows_ = 0;
+		std::shared_ptr<const detail::NameIndex> index_;
+		std::vector<Column> columns_;
+		std::pmr::vector<uint64_t> storage_;
+		std::vector<std::string_view> commands_;
+		std::vector<Failure> errors_;
+		// One per worker, holding the strings and list elements of its rows.
+		std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas_;
+
+		template<typename T, size_t I = 0>
+		static constexpr size_t alternative_of()
+		{
+			if constexpr (I == std::variant_size_v<detail::ValueView>) return std::variant_npos;
+			else if constexpr (std::is_same_v<std::variant_alternative_t<I, detail::ValueView>, T>) return I;
+			else return alternative_of<T, I + 1>();
+		}
+
+		BatchResult(std::shared_ptr<const detail::NameIndex> index, size_t rows, std::pmr::memory_resource* resource)
+			: rows_(rows), index_(std::move(index)), storage_(resource)
+		{
+		}
+
+		/**
+		 * @brief Lays out one column per argument.
+		 * @param empty For each argument, the value its cells start with; its alternative is the cell type.
+		 * @param mixed For each argument, whether its cells hold whole variants instead (AUTO arguments).
+		 */
+		void allocate(std::span<const detail::ValueView> empty, const std::vector<bool>& mixed)
+		{
+			size_t words = 0;
+			columns_.resize(empty.size());
+			for (size_t i = 0; i < empty.size(); ++i) {
+				columns_[i] = { mixed[i] ? std::variant_npos : empty[i].index(), words };
+				const size_t cell = mixed[i] ? sizeof(detail::ValueView) : std::visit([](const auto& held) { return sizeof(held); }, empty[i]);
+				words += (cell * rows_ + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+			}
+			storage_.assign(words, 0);
+			for (size_t i = 0; i < columns_.size(); ++i) {
+				if (mixed[i]) {
+					std::uninitialized_fill_n(cells<detail::ValueView>(columns_[i]), rows_, empty[i]);
+					continue;
+				}
+				std::visit([&](const auto& held) {
+					using Held = std::decay_t<decltype(held)>;
+					std::uninitialized_fill_n(cells<Held>(columns_[i]), rows_, held);
+				}, empty[i]);
+			}
+		}
+
+		void store(size_t i, size_t row, const detail::ValueView& value)
+		{
+			const Column& col = columns_[i];
+			if (col.alternative == std::variant_npos) {
+				cells<detail::ValueView>(col)[row] = value;
+				return;
+			}
+			std::visit([&](const auto& held) {
+				using Held = std::decay_t<decltype(held)>;
+				if (value.index() == col.alternative) cells<Held>(col)[row] = held;
+			}, value);
+		}
+
+		template<typename T>
+		T* cells(const Column& col) const
+		{
+			return std::launder(reinterpret_cast<T*>(const_cast<uint64_t*>(storage_.data()) + col.offset));
+		}
+
+		template<typename T>
+		std::span<const T> column(const Column& col) const
+		{
+			if (col.alternative != alternative_of<T>()) throw std::bad_variant_access();
+			return { cells<T>(col), rows_ };
+		}
+
+		const Column& find(std::string_view name) const
+		{
+			auto pos = index_ ? index_->find(detail::strip_dashes(name)) : std::nullopt;
+			if (!pos) {
+				throw std::out_of_range("Unknown argument: " + std::string(name));
+			}
+			return columns_[*pos];
+		}
+
+		friend class ArgumentParser;
+	};
+
+	/**
+	 * @brief Layout of the help text.
+	 *
+	 * TABS separates each option from its description with a tab; ALIGNED pads
+	 * the option column with spaces so all descriptions start in one column.
+	 */
+	enum class HelpLayout { TABS, ALIGNED };
+
+	/**
+	 * @brief Shell a completion script is written for.
+	 */
+	enum class Shell { BASH, ZSH, FISH };
+
+	namespace detail
+	{
+		/**
+		 * @brief Quotes text as one word for bash, zsh and fish: `it's` becomes `'it'\''s'`.
+		 */
+		inline std::string shell_quote(std::string_view text)
+		{
+			std::string quoted = "'";
+			for (char c : text) {
+				if (c == '\'') quoted += "'\\''";
+				else quoted += c;
+			}
+			return quoted += '\'';
+		}
+
+		/**
+		 * @brief Backslash-escapes the characters in `special` and folds newlines into spaces.
+		 */
+		inline std::string shell_escape(std::string_view text, std::string_view special)
+		{
+			std::string escaped;
+			for (char c : text) {
+				if (c == '\n') c = ' ';
+				else if (special.find(c) != std::string_view::npos) escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+	}
+
+	/**
+	 * @brief Command-line argument parser.
+	 *
+	 * This class allows you to define and parse command-line arguments for your application.
+	 *
+	 * Example usage:
+	 * @code
+	 * argparse::ArgumentParser parser("myapp");
+	 * parser.add_argument("mode")
+	 *       .help("Mode of operation")
+	 *       .choices({ "debug", "release" });
+	 *
+	 * auto args = parser.parse_args(argc, argv);
+	 * std::string mode = args.get<std::string>("mode");
+	 * @endcode
+	 */
+	class ArgumentParser
+	{
+		bool auto_help_ = true;
+		bool response_files_ = false;
+		bool allow_abbrev_ = false;
+		bool lazy_ = false;
+		bool completion_ = false;
+		std::string prog_name_;
+		// Owned by this parser; compiled indexes keep it alive and view names in place.
+		std::shared_ptr<detail::NameTable> names_ = std::make_shared<detail::NameTable>();
+		std::vector<Argument> args_;
+		std::shared_ptr<const detail::NameIndex> lookup_;
+		std::shared_ptr<const EnvSnapshot> env_;
+		std::shared_ptr<const ConfigFile> config_;
+		std::string config_prefix_;
+		uint64_t schema_hash_ = 0;
+
+		/**
+		 * @brief The part of an argument that a parse reads for every argument.
+		 *
+		 * An Argument is several hundred bytes of names, help text, choices and
+		 * validators. compile() copies what the tokenizer and the default-filling
+		 * loop need into these slots, so a parse walks one dense array and only
+		 * opens an Argument to convert a value it was actually given.
+		 *
+		 * `value` is what the argument holds when argv leaves it unset: the
+		 * default, or the value from the environment snapshot or configuration
+		 * file, already converted.
+		 */
+		struct Slot
+		{
+			enum : uint8_t { FLAG = 1, LIST = 2, APPEND = 4, REQUIRED = 8, CHECK_ENV = 16, FOUND = 32, NEGATIVE = 64 };
+
+			detail::ValueView value;    ///< An empty ListView of the element type for lists.
+			std::string_view text;      ///< The environment or file text behind `value`; lists convert it per parse.
+			uint32_t nargs_min = 1;
+			uint32_t nargs_max = 1;     ///< Saturated at the uint32_t maximum for Argument::unbounded.
+			ParseError::Code code = ParseError::Code::NONE;  ///< Result of converting `text`.
+			uint8_t flags = 0;          ///< CHECK_ENV: no snapshot, so consult getenv at parse time before `text`.
+			                            ///< NEGATIVE: numeric, so a value may start with '-', e.g. "-5".
+
+			bool has(uint8_t flag) const
+			{
+				return (flags & flag) != 0;
+			}
+		};
+
+		/**
+		 * @brief The slots of a compiled schema, with the text their views refer to.
+		 */
+		struct HotSchema
+		{
+			std::vector<Slot> slots;
+			std::string defaults;                       ///< Copies of the string defaults.
+			std::shared_ptr<const EnvSnapshot> env;     ///< Holders of the fallback texts.
+			std::shared_ptr<const ConfigFile> config;
+		};
+		std::shared_ptr<const HotSchema> hot_;
+
+		/**
+		 * @brief Builds the slots, resolving fallbacks: environment snapshot, then configuration file.
+		 */
+		void build_slots();
+
+		/**
+		 * @brief A subcommand whose parser is only built when it is first selected.
+		 */
+		struct Subcommand
+		{
+			std::string name;
+			std::string help;
+			std::function<void(ArgumentParser&)> builder;
+			mutable std::once_flag built;                    ///< Concurrent parses may be the first to select it.
+			mutable std::unique_ptr<ArgumentParser> parser;
+		};
+
+		/**
+		 * @brief The declared subcommands, each owned by one parser.
+		 *
+		 * A copy takes the names, help texts and builders but none of the built
+		 * parsers, so every copy of a parser builds its subcommands from its own
+		 * settings the first time it selects them.
+		 */
+		class Commands
+		{
+			std::vector<std::unique_ptr<Subcommand>> list_;
+
+		public:
+			Commands() = default;
+			Commands(Commands&&) = default;
+			Commands& operator=(Commands&&) = default;
+
+			Commands(const Commands& other)
+			{
+				list_.reserve(other.list_.size());
+				for (const auto& command : other.list_) add(command->name, command->help, command->builder);
+			}
+
+			Commands& operator=(const Commands& other)
+			{
+				if (this != &other) *this = Commands(other);
+				return *this;
+			}
+
+			void add(std::string name, std::string help, std::function<void(ArgumentParser&)> builder)
+			{
+				list_.push_back(std::make_unique<Subcommand>(std::move(name), std::move(help), std::move(builder)));
+			}
+
+			/**
+			 * @brief Drops the built parsers, which snapshot settings that just changed.
+			 */
+			void reset()
+			{
+				*this = Commands(*this);
+			}
+
+			auto begin() const { return list_.begin(); }
+			auto end() const { return list_.end(); }
+			size_t size() const { return list_.size(); }
+			bool empty() const { return list_.empty(); }
+			const std::unique_ptr<Subcommand>& operator[](size_t i) const { return list_[i]; }
+		};
+		Commands commands_;
+
+		const Subcommand* find_command(std::string_view name) const
+		{
+			for (const auto& command : commands_) {
+				if (command->name == name) return command.get();
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief Runs a subcommand's builder once, even when parses race on it.
+		 *
+		 * The child takes this parser's help, environment and configuration settings
+		 * (and instrumentation counters) before the builder runs, and is compiled
+		 * right after it. Changing those settings here drops the built children.
+		 */
+		const ArgumentParser& build(const Subcommand& command) const
+		{
+			std::call_once(command.built, [&] {
+				auto child = std::make_unique<ArgumentParser>(prog_name_ + " " + command.name);
+				child->auto_help_ = auto_help_;
+				child->env_ = env_;
+				child->config_ = config_;
+				child->config_prefix_ = config_prefix_ + command.name + ".";
+				child->counters_ = counters_;
+				command.builder(*child);
+				child->compile();
+				command.parser = std::move(child);
+			});
+			return *command.parser;
+		}
+
+		/**
+		 * @brief Parse-time settings a subcommand takes from the parser that selected it.
+		 *
+		 * Passed down on every parse rather than copied into the child, so they
+		 * follow the parent as it is now. A child that enables one itself keeps it.
+		 */
+		struct Inherited
+		{
+			bool allow_abbrev = false;
+			bool lazy = false;
+		};
+
+		/**
+		 * @brief Skips this parser's options and their values the way run() does.
+		 * @return The first word in option position, which names the subcommand if
+		 *         there is one, or std::nullopt if the tokens run out first.
+		 */
+		std::optional<std::string_view> command_word(detail::TokenStream& tokens, bool abbrev) const
+		{
+			while (!tokens.done()) {
+				const detail::Token token = tokens.next();
+				if (token.kind == detail::Token::Kind::VALUE) return token.text;
+
+				auto pos = lookup_->find(token.name);
+				if (!pos && abbrev && token.kind == detail::Token::Kind::LONG) {
+					bool ambiguous = false;
+					pos = match_prefix(token, ambiguous);
+				}
+				if (!pos) continue;
+				const Slot& slot = hot_->slots[*pos];
+				if (slot.has(Slot::FLAG)) continue;
+				const size_t count = slot.has(Slot::LIST) ? slot.nargs_max : 1;
+				for (size_t taken = 0; taken < count && tokens.next_is_value(slot.has(Slot::NEGATIVE)); ++taken) tokens.next();
+			}
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief Help text formatted on first request after compile() and reused until the schema changes.
+		 */
+		struct HelpCache
+		{
+			std::once_flag built;
+			std::atomic<bool> ready{ false };
+			std::string text;
+		};
+		std::shared_ptr<HelpCache> help_cache_;
+		// Null unless instrumented, but always declared so the layout does not depend on ARGPARSE_INSTRUMENTATION.
+		std::shared_ptr<detail::StatsCounters> counters_ = ParseStats::enabled ? std::make_shared<detail::StatsCounters>() : nullptr;
+
+		static size_t option_width(const Argument& arg)
+		{
+			size_t width = 2 + arg.name().size();
+			for (const auto& alias : arg.aliases()) width += 3 + alias.size();
+			return width;
+		}
+
+		/**
+		 * @brief Separates the option column from the description: a tab, or spaces up to `width`.
+		 */
+		template<typename Sink>
+		static void write_gap(Sink& out, size_t width, size_t used)
+		{
+			if (width == 0) {
+				out("\t");
+				return;
+			}
+			static constexpr std::string_view spaces = "                                ";
+			for (size_t pad = width - used + 2; pad > 0;) {
+				const size_t n = std::min(pad, spaces.size());
+				out(spaces.substr(0, n));
+				pad -= n;
+			}
+		}
+
+		template<typename Sink, typename T>
+		static void write_number(Sink& out, T value)
+		{
+			// Matches the default std::ostream formatting the help text has always used.
+			char buffer[64];
+			std::to_chars_result result;
+			if constexpr (std::is_floating_point_v<T>) result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+			else result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out(std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+		}
+
+		template<typename Sink>
+		static void write_help_line(Sink& out, const Argument& arg, size_t width)
+		{
+			out("  --");
+			out(arg.name());
+			for (const auto& alias : arg.aliases()) {
+				out(", -");
+				out(alias);
+			}
+			write_gap(out, width, option_width(arg));
+			out(arg.help());
+
+			const auto& def = arg.default_value();
+			if (arg.is_list()) {
+				out(arg.is_append() ? " (repeatable)" : " (list)");
+			}
+			else if (const std::string* choice = std::holds_alternative<int>(def) && arg.type() == Argument::ArgType::STRING
+				? arg.choice_name(std::get<int>(def)) : nullptr) {
+				out(" [default: ");
+				out(*choice);
+				out("]");
+			}
+			else {
+				out(" [default: ");
+				if (auto text = std::get_if<std::string>(&def)) out(*text);
+				else if (auto number = std::get_if<int>(&def)) write_number(out, *number);
+				else if (auto real = std::get_if<float>(&def)) write_number(out, *real);
+				else if (auto wide = std::get_if<int64_t>(&def)) {
+					if (arg.type() == Argument::ArgType::DURATION) out(detail::format_duration(*wide));
+					else write_number(out, *wide);
+				}
+				else if (auto count = std::get_if<uint64_t>(&def)) {
+					if (arg.type() == Argument::ArgType::SIZE) out(detail::format_size(*count));
+					else write_number(out, *count);
+				}
+				else if (auto precise = std::get_if<double>(&def)) write_number(out, *precise);
+				else out(std::get<bool>(def) ? "1" : "0");
+				out("]");
+			}
+
+			if (!arg.choices().empty()) {
+				out(" (choices: ");
+				for (size_t i = 0; i < arg.choices().size(); ++i) {
+					if (i) out(", ");
+					out(arg.choices()[i]);
+				}
+				out(")");
+			}
+
+			if (arg.is_required()) {
+				out(" (required)");
+			}
+			out("\n");
+		}
+
+		/**
+		 * @brief Writes the help text piece by piece to `out`, a callable taking std::string_view.
+		 */
+		template<typename Sink>
+		void emit_help(Sink& out, HelpLayout layout) const
+		{
+			ARGPARSE_PHASE_FOR(counters_.get(), HELP);
+			out("Usage: ");
+			out(prog_name_);
+			out(" [OPTIONS]\n");
+			if (!commands_.empty()) {
+				out("   or: ");
+				out(prog_name_);
+				out(" [OPTIONS] <COMMAND> [COMMAND OPTIONS]\n");
+			}
+
+			// The aligned layout needs only the widest first column, found in one pass.
+			size_t width = 0;
+			if (layout == HelpLayout::ALIGNED) {
+				for (const auto& arg : args_) width = std::max(width, option_width(arg));
+				for (const auto& command : commands_) width = std::max(width, command->name.size());
+			}
+
+			out("\nOptions:\n");
+			for (const auto& arg : args_) write_help_line(out, arg, width);
+
+			if (!commands_.empty()) {
+				out("\nCommands:\n");
+				for (const auto& command : commands_) {
+					out("  ");
+					out(command->name);
+					write_gap(out, width, command->name.size());
+					out(command->help);
+					out("\n");
+				}
+			}
+		}
+
+		/**
+		 * @brief The cached tab-separated help text, or nullptr if it has not been built.
+		 */
+		const std::string* cached_help() const
+		{
+			return help_cache_ && help_cache_->ready.load(std::memory_order_acquire) ? &help_cache_->text : nullptr;
+		}
+
+	public:
+		/**
+		 * @brief Create a new ArgumentParser with the given program name.
+		 * @param prog_name The name of the program, typically argv[0].
+		 */
+		explicit ArgumentParser(std::string prog_name) : prog_name_(std::move(prog_name)) {}
+
+		/**
+		 * @brief Copies the schema; the copy gets its own name table and unbuilt subcommands.
+		 *
+		 * Compiled lookups are shared, as they are immutable. Either parser
+		 * can then be extended without affecting the other.
+		 */
+		ArgumentParser(const ArgumentParser& other)
+			: auto_help_(other.auto_help_), response_files_(other.response_files_), allow_abbrev_(other.allow_abbrev_),
+			  lazy_(other.lazy_), completion_(other.completion_), prog_name_(other.prog_name_),
+			  names_(std::make_shared<detail::NameTable>(*other.names_)), args_(other.args_), lookup_(other.lookup_),
+			  env_(other.env_), config_(other.config_), config_prefix_(other.config_prefix_), schema_hash_(other.schema_hash_),
+			  hot_(other.hot_), commands_(other.commands_), help_cache_(other.help_cache_), counters_(other.counters_)
+		{
+			for (auto& arg : args_) arg.names_ = names_.get();
+		}
+
+		ArgumentParser(ArgumentParser&&) = default;
+		ArgumentParser& operator=(ArgumentParser&&) = default;
+
+		ArgumentParser& operator=(const ArgumentParser& other)
+		{
+			if (this != &other) *this = ArgumentParser(other);
+			return *this;
+		}
+
+		/**
+		 * @brief Add a subcommand whose arguments are declared on first use.
+		 *
+		 * The first word that is not an option or an option's value names the
+		 * subcommand: this parser takes the options before it, and the rest of
+		 * the command line is parsed by the subcommand. The first time a
+		 * subcommand is selected, `builder` is called with a fresh parser named
+		 * "<prog> <name>". Schemas of subcommands that are never selected are
+		 * never built; help() lists them by name and help text alone. The
+		 * subcommand abbreviates and parses lazily whenever this parser does.
+		 *
+		 * @code
+		 * parser.add_subcommand("clone", [](argparse::ArgumentParser& clone) {
+		 *     clone.add_argument("depth").type_int().default_value(0);
+		 * }, "Clone a repository");
+		 * @endcode
+		 *
+		 * @param name The subcommand, matched exactly.
+		 * @param builder Declares the subcommand's arguments on the parser it is given.
+		 * @param help Description shown in the parent's help.
+		 * @return Reference to this parser.
+		 * @throws ArgumentError if a subcommand with that name already exists.
+		 */
+		ArgumentParser& add_subcommand(std::string name, std::function<void(ArgumentParser&)> builder, std::string help = "")
+		{
+			if (find_command(name)) throw ArgumentError("Duplicate subcommand: " + name);
+			commands_.add(std::move(name), std::move(help), std::move(builder));
+			help_cache_.reset();
+			return *this;
+		}
+
+		/**
+		 * @brief The parser of a subcommand, building it if it has not been selected yet.
+		 * @param name The subcommand name.
+		 * @return The compiled subcommand parser; it lives until this parser is changed.
+		 * @throws ArgumentError if there is no such subcommand.
+		 */
+		const ArgumentParser& subcommand(std::string_view name) const
+		{
+			const Subcommand* command = find_command(name);
+			if (!command) throw ArgumentError("Unknown subcommand: " + std::string(name));
+			return build(*command);
+		}
+
+		/**
+		 * @brief Enable or disable automatic help display.
+		 * @param enable If true, also displays help when no arguments are given; --help and -h always do.
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& auto_help(bool enable)
+		{
+			auto_help_ = enable;
+			commands_.reset();
+			return *this;
+		}
+
+		/**
+		 * @brief Enable or disable `@file` response-file expansion.
+		 *
+		 * When enabled, a token `@path` is replaced by the whitespace-separated
+		 * tokens of that file, with '...'/"..." quoting and backslash escapes.
+		 * Response files may reference further response files.
+		 *
+		 * @param enable If true, expands `@path` tokens.
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& response_files(bool enable = true)
+		{
+			response_files_ = enable;
+			return *this;
+		}
+
+		/**
+		 * @brief Accept unambiguous prefixes of long options, e.g. `--verb` for `--verbose`.
+		 *
+		 * Exact names always win; a prefix shared by several arguments is an error.
+		 *
+		 * @param enable If true, long options may be abbreviated.
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& allow_abbrev(bool enable = true)
+		{
+			allow_abbrev_ = enable;
+			return *this;
+		}
+
+		/**
+		 * @brief Convert and validate values when they are first read instead of during the parse.
+		 *
+		 * A parse then only stores the text given for each option, and a
+		 * program that reads a few of many options pays for converting those
+		 * few. Errors in a value surface as ArgumentError from the read;
+		 * ParsedArgs::validate_all() checks everything at once. Lists,
+		 * defaults and configuration values are still converted eagerly.
+		 * The results refer to this parser until validate_all() has run.
+		 *
+		 * @param enable If true, parses defer conversion.
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& lazy(bool enable = true)
+		{
+			lazy_ = enable;
+			return *this;
+		}
+
+		/**
+		 * @brief Answer shell completion requests in parse_args().
+		 *
+		 * `prog --complete WORD...` prints the candidates for the last WORD,
+		 * one per line, using the words before it as context; see complete().
+		 * `prog --completion-script bash|zsh|fish` prints a script that
+		 * completes from the schema without starting the program. Both exit.
+		 *
+		 * @param enable If true, parse_args() handles both requests.
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& completion(bool enable = true)
+		{
+			completion_ = enable;
+			return *this;
+		}
+
+		/**
+		 * @brief Resolve `env()` fallbacks from a snapshot instead of calling `getenv`.
+		 * @param snapshot The environment to use, typically EnvSnapshot::capture().
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& env_snapshot(EnvSnapshot snapshot)
+		{
+			env_ = std::make_shared<const EnvSnapshot>(std::move(snapshot));
+			commands_.reset();
+			if (lookup_) build_slots();
+			return *this;
+		}
+
+		/**
+		 * @brief Fill arguments that argv and the environment leave unset from a configuration file.
+		 *
+		 * Precedence is argv, then `env()` variables, then the file, then default
+		 * values. Keys are argument names or aliases; a subcommand reads the keys
+		 * of its own `[name]` section. A required argument set in the file counts
+		 * as given. The file's values are converted and validated once, when the
+		 * parser compiles, and reported on the first parse that needs them.
+		 *
+		 * @param file The settings, e.g. from ConfigFile::open().
+		 * @return Reference to this parser.
+		 */
+		ArgumentParser& config(ConfigFile file)
+		{
+			config_ = std::make_shared<const ConfigFile>(std::move(file));
+			commands_.reset();
+			if (lookup_) build_slots();
+			return *this;
+		}
+
+		/**
+		 * @brief Add a new command-line argument.
+		 *
+		 * Creates a new `Argument` object and returns a reference to it so you can chain configuration calls.
+		 *
+		 * @param name The name of the argument (e.g., "input" or "--file"); it is copied into the schema's name table.
+		 * @return Reference to the newly created Argument object.
+		 */
+		Argument& add_argument(std::string_view name)
+		{
+			lookup_.reset();
+			help_cache_.reset();
+			args_.emplace_back(*names_, name);
+			args_.back().index_ = args_.size() - 1;
+			return args_.back();
+		}
+
+		/**
+		 * @brief Freeze the schema and build its name lookup.
+		 *
+		 * Validates names, aliases and choices once and keeps immutable lookups that every
+		 * later parse reuses. parse_args compiles on first use; call this explicitly
+		 * to surface schema errors early. Adding an argument un-freezes the parser;
+		 * changing an existing Argument after compiling requires compiling again.
+		 *
+		 * @return Reference to this parser.
+		 * @throws ArgumentError if a name, alias or choice is used twice.
+		 */
+		ArgumentParser& compile();
+
+		/**
+		 * @brief Hash of everything in the compiled schema that affects parsed values.
+		 *
+		 * Subcommands count by name; each subcommand's snapshot carries its own schema hash.
+		 */
+		uint64_t schema_hash() const
+		{
+			return schema_hash_;
+		}
+
+		/**
+		 * @brief Time and allocations per phase, accumulated over this parser's lifetime.
+		 *
+		 * Copies of a parser share counters. All zero unless compiled with
+		 * ARGPARSE_INSTRUMENTATION=1; see ParseStats.
+		 */
+		ParseStats stats() const
+		{
+			ParseStats stats;
+			if (!counters_) return stats;
+			ParseStats::Phase* phases[] = { &stats.build_lookup, &stats.tokenize, &stats.env, &stats.validate, &stats.convert, &stats.help };
+			for (size_t i = 0; i < std::size(phases); ++i) {
+				const auto& counter = counters_->phases[i];
+				phases[i]->calls = counter.calls.load(std::memory_order_relaxed);
+				phases[i]->nanoseconds = counter.nanoseconds.load(std::memory_order_relaxed);
+				phases[i]->allocations = counter.allocations.load(std::memory_order_relaxed);
+			}
+			return stats;
+		}
+
+		/**
+		 * @brief Zero the counters reported by stats().
+		 */
+		void reset_stats()
+		{
+			if (!counters_) return;
+			for (auto& counter : counters_->phases) {
+				counter.calls.store(0, std::memory_order_relaxed);
+				counter.nanoseconds.store(0, std::memory_order_relaxed);
+				counter.allocations.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * @brief All declared arguments, in declaration order.
+		 */
+		const std::vector<Argument>& arguments() const
+		{
+			return args_;
+		}
+
+		/**
+		 * @brief Check whether the schema is frozen.
+		 * @return True if compile() has run since the last schema change.
+		 */
+		bool compiled() const
+		{
+			return lookup_ != nullptr;
+		}
+
+		/**
+		 * @brief Get a formatted help string showing all arguments and their descriptions.
+		 *
+		 * Once the parser is compiled the text is formatted on the first call and
+		 * cached until the schema changes; later calls return a copy.
+		 *
+		 * @return The help text as a string.
+		 */
+		std::string help() const;
+
+		/**
+		 * @brief Write the help text to a stream without building it as one string.
+		 * @param out The stream.
+		 * @param layout TABS for the help() format, ALIGNED for padded columns.
+		 */
+		void write_help(std::ostream& out, HelpLayout layout = HelpLayout::TABS) const;
+
+		/**
+		 * @brief Write the help text to a C stream without building it as one string.
+		 * @param out The stream, e.g. stdout.
+		 * @param layout TABS for the help() format, ALIGNED for padded columns.
+		 */
+		void write_help(std::FILE* out, HelpLayout layout = HelpLayout::TABS) const;
+
+		/**
+		 * @brief Parse the command-line arguments.
+		 *
+		 * Parses `argc` and `argv`, applying validations, default values, environment fallbacks, etc.
+		 * If `--help` or `-h` is passed, or no arguments and `auto_help` is enabled, it prints help and exits.
+		 *
+		 * @param argc Argument count (from `main`).
+		 * @param argv Argument values (from `main`).
+		 * @return A ParsedArgs object to retrieve argument values by name.
+		 * @throws ArgumentError If any validation fails or required argument is missing.
+		 */
+		ParsedArgs parse_args(int argc, char** argv);
+
+		/**
+		 * @brief Parse the command-line arguments, returning errors instead of throwing them.
+		 *
+		 * Like parse_args, but it never throws, prints or exits, and formats no
+		 * text: failures come back as a ParseError whose message() is only built
+		 * on request. A help request is reported as Code::HELP_REQUESTED, with
+		 * parser() naming the parser whose help to show.
+		 *
+		 * @param argc Argument count (from `main`).
+		 * @param argv Argument values (from `main`).
+		 * @return The parsed arguments, or why they were rejected.
+		 */
+		expected<ParsedArgs, ParseError> try_parse_args(int argc, const char* const* argv);
+
+		/**
+		 * @brief Parse the command-line arguments without side effects.
+		 *
+		 * Reentrant counterpart of parse_args: it never prints, never exits and
+		 * never modifies the parser, so one compiled parser can be shared by any
+		 * number of threads. Help requests and errors are reported in the result.
+		 * The one exception is the first selection of a subcommand, which builds
+		 * its parser exactly once under std::call_once.
+		 *
+		 * All per-parse memory comes from `resource`: small schemas need exactly one
+		 * allocation, the block that holds the returned values.
+		 *
+		 * @param argc Argument count.
+		 * @param argv Argument values; argv[0] is skipped.
+		 * @param resource Memory resource for the results and any scratch space.
+		 * @return The parsed arguments, a help request, or an error message.
+		 */
+		ParseResult parse(int argc, const char* const* argv,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+		/**
+		 * @brief Parse an already split list of arguments without a program name.
+		 * @param tokens The arguments; they must stay alive until this returns.
+		 * @param resource Memory resource for the results and any scratch space.
+		 * @return The parsed arguments, a help request, or an error message.
+		 */
+		ParseResult parse_tokens(std::span<const std::string_view> tokens,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+		/**
+		 * @brief Parse arguments stored in a file, like a response file.
+		 *
+		 * The file is memory-mapped and tokenized in place; tokens go straight to
+		 * the parser without building an argv array or copying each token.
+		 *
+		 * @param path Path of the file.
+		 * @param resource Memory resource for the results and any scratch space.
+		 * @return The parsed arguments, a help request, or an error message.
+		 */
+		ParseResult parse_file(const std::string& path,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+		/**
+		 * @brief Parse arguments read from a stream, such as stdin.
+		 * @param in The stream; it is read to the end.
+		 * @param resource Memory resource for the results and any scratch space.
+		 * @return The parsed arguments, a help request, or an error message.
+		 */
+		ParseResult parse_stream(std::istream& in,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+		/**
+		 * @brief Parse many command lines against this schema into one columnar result.
+		 *
+		 * Each line is parsed as by parse_tokens(), without a program name, and
+		 * lazy values are validated right away. The lines are split into one
+		 * contiguous range per worker thread. A worker parses every line in
+		 * the same scratch arena and copies strings and list elements into an
+		 * arena of its own, so the allocations do not grow with the number of
+		 * lines, only with the bytes they hold.
+		 *
+		 * @code
+		 * std::vector<std::vector<std::string_view>> lines = ...;
+		 * argparse::BatchResult batch = parser.parse_batch(lines, 0);
+		 * for (const auto& failure : batch.errors()) report(failure.row, failure.error.message());
+		 * std::span<const int> jobs = batch[jobs_key];
+		 * @endcode
+		 *
+		 * @param lines The command lines: a random-access range whose elements convert to
+		 *        std::span<const std::string_view>. They need not outlive the call.
+		 * @param threads Worker threads; 0 uses std::thread::hardware_concurrency().
+		 * @param resource Memory resource for the columns and the arenas.
+		 * @return One row per line.
+		 * @throws ArgumentError if the parser is not compiled.
+		 */
+		template<typename Lines>
+			requires std::random_access_iterator<detail::line_iterator_t<Lines>> &&
+				std::convertible_to<std::iter_reference_t<detail::line_iterator_t<Lines>>, std::span<const std::string_view>>
+		BatchResult parse_batch(const Lines& lines, unsigned threads = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+		{
+			const BatchLine line = [](const ArgumentParser& parser, const void* context, size_t row, std::pmr::memory_resource* scratch) {
+				return parser.parse_tokens(std::span<const std::string_view>(std::begin(*static_cast<const Lines*>(context))[row]), scratch);
+			};
+			return parse_lines(&lines, static_cast<size_t>(std::size(lines)), line, threads, resource);
+		}
+
+		/**
+		 * @brief Completion candidates for a partly typed command line.
+		 *
+		 * The last word is the one being completed. After an option that takes a
+		 * value it completes that option's choices; a word starting with '-'
+		 * completes option names, spelled as help() shows them; any other word
+		 * before a subcommand completes subcommand names, and after a
+		 * subcommand the rest goes to its parser. Names and choices are looked up in the sorted indexes
+		 * built by compile(), so the time depends on the prefix and the number
+		 * of candidates, not on the size of the schema.
+		 *
+		 * @param words The words after the program name, ending with the partial one (possibly empty).
+		 * @return The candidates, sorted.
+		 * @throws ArgumentError if the parser is not compiled.
+		 */
+		std::vector<std::string> complete(std::span<const std::string_view> words) const;
+
+		/**
+		 * @brief Write a completion script for this parser and its subcommands.
+		 *
+		 * The script holds every option, alias, choice and subcommand, so the
+		 * shell completes without starting the program; it builds the schema of
+		 * every subcommand. For bash and zsh, load it with `source <(prog
+		 * --completion-script bash)`; for fish, save it as
+		 * `~/.config/fish/completions/prog.fish`.
+		 *
+		 * @param out The stream.
+		 * @param shell The shell the script is for.
+		 * @throws ArgumentError if the parser is not compiled.
+		 */
+		void write_completion_script(std::ostream& out, Shell shell) const;
+
+		/**
+		 * @brief Hash of a command line and of every environment variable it could read.
+		 *
+		 * Covers argv after the program name, the `env()` variable of each
+		 * argument and its configuration value, including those of the
+		 * subcommand the command line selects. Two invocations with the same hash parse
+		 * to the same values.
+		 *
+		 * @param argc Argument count.
+		 * @param argv Argument values; argv[0] is skipped.
+		 * @return The hash, or std::nullopt if the result also depends on response files.
+		 */
+		std::optional<uint64_t> input_hash(int argc, const char* const* argv) const;
+
+		/**
+		 * @brief Serializes parse results into a compact binary snapshot.
+		 *
+		 * The snapshot is the results' single block as it is in memory, behind a
+		 * header holding schema_hash(), `input_hash` and a checksum. A selected
+		 * subcommand's results are appended as a nested snapshot.
+		 *
+		 * @param args Results produced by this parser.
+		 * @param input_hash Usually input_hash() of the command line that produced them.
+		 * @return The snapshot bytes.
+		 * @throws ArgumentError if `args` came from a different parser, or a lazily parsed value is rejected.
+		 */
+		std::string snapshot(const ParsedArgs& args, uint64_t input_hash) const;
+
+		/**
+		 * @brief Rebuilds results from a snapshot without parsing, converting or validating.
+		 *
+		 * Costs one allocation from `resource`, a copy of the block and one pass
+		 * to repoint string and list views; a subcommand adds the same for its part.
+		 *
+		 * @param data The snapshot, e.g. a memory-mapped cache file.
+		 * @param input_hash The hash the snapshot must have been written with.
+		 * @param resource Memory resource for the results.
+		 * @return The results, or std::nullopt if the snapshot is for another schema
+		 *         or input, was written by an incompatible build, or is damaged.
+		 */
+		std::optional<ParsedArgs> restore(std::span<const char> data, uint64_t input_hash,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+		/**
+		 * @brief parse() with a snapshot cache for repeated identical invocations.
+		 *
+		 * The cache file is memory-mapped and used when its schema and input
+		 * hashes match this parser and input_hash() of the command line; the
+		 * values then come back without validation or conversion. Otherwise the
+		 * command line is parsed and, if that succeeds, its snapshot replaces
+		 * the file. The file holds one entry; use input_hash() in the path to
+		 * keep several. Failing to read or write the cache only costs the parse.
+		 *
+		 * @param argc Argument count.
+		 * @param argv Argument values; argv[0] is skipped.
+		 * @param cache_path The cache file.
+		 * @param resource Memory resource for the results and any scratch space.
+		 * @return The parsed arguments, a help request, or an error message.
+		 */
+		ParseResult parse_cached(int argc, const char* const* argv, const std::string& cache_path,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+	private:
+		using ScriptParsers = std::vector<std::pair<std::string_view, const ArgumentParser*>>;
+
+		/**
+		 * @brief An argument's spellings as help() shows them: `--name`, then `-alias` for each alias.
+		 */
+		static std::vector<std::string> spellings(const Argument& arg)
+		{
+			std::vector<std::string> names{ "--" + std::string(arg.name()) };
+			for (std::string_view alias : arg.aliases()) names.push_back("-" + std::string(alias));
+			return names;
+		}
+
+		/**
+		 * @brief Whether a shell should offer file names for an argument's value.
+		 */
+		static bool completes_files(const Argument& arg)
+		{
+			return arg.choices().empty() && (arg.type() == Argument::ArgType::STRING || arg.type() == Argument::ArgType::AUTO);
+		}
+
+		/**
+		 * @brief Every option a parser accepts, separated by spaces, for `compgen -W`.
+		 */
+		std::string option_words() const
+		{
+			std::string words = "--help -h";
+			for (const auto& arg : args_) {
+				for (const auto& name : spellings(arg)) {
+					// parse() reads these as --help whatever they are declared as.
+					if (detail::classify(name).is_help()) continue;
+					if (!words.empty()) words += ' ';
+					words += name;
+				}
+			}
+			return words;
+		}
+
+		void write_bash_script(std::ostream& out, const ScriptParsers& parsers, const std::string& function) const
+		{
+			std::string commands;
+			for (const auto& command : commands_) commands += (commands.empty() ? "" : " ") + command->name;
+
+			out << "# bash completion for " << prog_name_ << "\n";
+			out << function << "() {\n";
+			out << "    local cur=${COMP_WORDS[COMP_CWORD]} prev=${COMP_WORDS[COMP_CWORD-1]} cmd=\n";
+			if (!commands_.empty()) {
+				out << "    if [[ $COMP_CWORD -gt 1 ]]; then\n        case ${COMP_WORDS[1]} in\n            ";
+				for (size_t i = 0; i < commands_.size(); ++i) out << (i ? "|" : "") << detail::shell_quote(commands_[i]->name);
+				out << ") cmd=${COMP_WORDS[1]} ;;\n        esac\n    fi\n";
+			}
+
+			// The value of an option, keyed by subcommand and option.
+			out << "    case $cmd:$prev in\n";
+			for (const auto& [command, parser] : parsers) {
+				for (const auto& arg : parser->args_) {
+					if (arg.is_flag()) continue;
+					out << "        ";
+					const auto names = spellings(arg);
+					for (size_t i = 0; i < names.size(); ++i) out << (i ? "|" : "") << detail::shell_quote(std::string(command) + ":" + names[i]);
+					if (completes_files(arg)) out << ") COMPREPLY=($(compgen -f -- \"$cur\")); return ;;\n";
+					else if (arg.choices().empty()) out << ") COMPREPLY=(); return ;;\n";
+					else out << ") COMPREPLY=($(compgen -W " << detail::shell_quote(Argument::join_strings(arg.choices(), " ")) << " -- \"$cur\")); return ;;\n";
+				}
+			}
+			out << "    esac\n";
+
+			out << "    case $cmd in\n";
+			for (const auto& [command, parser] : parsers) {
+				if (command.empty()) continue;
+				out << "        " << detail::shell_quote(command) << ") COMPREPLY=($(compgen -W " << detail::shell_quote(parser->option_words())
+					<< " -- \"$cur\")) ;;\n";
+			}
+			out << "        *) ";
+			if (!commands_.empty()) {
+				out << "if [[ $COMP_CWORD -eq 1 && $cur != -* ]]; then COMPREPLY=($(compgen -W " << detail::shell_quote(commands)
+					<< " -- \"$cur\")); else COMPREPLY=($(compgen -W " << detail::shell_quote(option_words()) << " -- \"$cur\")); fi ;;\n";
+			}
+			else {
+				out << "COMPREPLY=($(compgen -W " << detail::shell_quote(option_words()) << " -- \"$cur\")) ;;\n";
+			}
+			out << "    esac\n}\n";
+			out << "complete -F " << function << " " << detail::shell_quote(prog_name_) << "\n";
+		}
+
+		/**
+		 * @brief The `_arguments` specs of a parser's options, one quoted spec per line.
+		 */
+		void write_zsh_specs(std::ostream& out, std::string_view indent) const
+		{
+			out << " \\\n" << indent << "'(- *)'{-h,--help}'[Show help]'";
+			for (const auto& arg : args_) {
+				const std::string help = detail::shell_escape(arg.help(), "\\[]:");
+				std::string value;
+				if (!arg.is_flag()) {
+					value = ":" + detail::shell_escape(arg.name(), "\\:") + ":";
+					if (completes_files(arg)) {
+						value += "_files";
+					}
+					else if (arg.choices().empty()) {
+						value += " ";
+					}
+					else {
+						value += "(";
+						for (size_t i = 0; i < arg.choices().size(); ++i) value += (i ? " " : "") + detail::shell_escape(arg.choices()[i], "\\:() ");
+						value += ")";
+					}
+				}
+				for (const auto& name : spellings(arg)) {
+					out << " \\\n" << indent << detail::shell_quote("*" + name + "[" + help + "]" + value);
+				}
+			}
+		}
+
+		void write_zsh_script(std::ostream& out, const ScriptParsers& parsers, const std::string& function) const
+		{
+			out << "#compdef " << prog_name_ << "\n";
+			out << "# zsh completion for " << prog_name_ << "\n";
+			out << function << "() {\n";
+			if (!commands_.empty()) {
+				out << "    if (( CURRENT > 2 )); then\n        case $words[2] in\n";
+				for (const auto& [command, parser] : parsers) {
+					if (command.empty()) continue;
+					out << "            " << detail::shell_quote(command) << ")\n                _arguments -S";
+					parser->write_zsh_specs(out, "                    ");
+					out << "\n                return ;;\n";
+				}
+				out << "        esac\n    fi\n";
+			}
+			out << "    _arguments -S";
+			write_zsh_specs(out, "        ");
+			if (!commands_.empty()) {
+				std::string commands;
+				for (const auto& command : commands_) {
+					commands += (commands.empty() ? "" : " ") + detail::shell_escape(command->name, "\\:() ") + "\\:\"" +
+						detail::shell_escape(command->help, "\\\"") + "\"";
+				}
+				out << " \\\n        " << detail::shell_quote("1:command:((" + commands + "))");
+			}
+			out << "\n}\n";
+			out << "if [[ $funcstack[1] == " << function << " ]]; then\n    " << function << " \"$@\"\nelse\n    compdef " << function << " "
+				<< detail::shell_quote(prog_name_) << "\nfi\n";
+		}
+
+		void write_fish_script(std::ostream& out, const ScriptParsers& parsers) const
+		{
+			std::string commands;
+			for (const auto& command : commands_) commands += (commands.empty() ? "" : " ") + detail::shell_quote(command->name);
+			const std::string program = detail::shell_quote(prog_name_);
+
+			out << "# fish completion for " << prog_name_ << "\n";
+			out << "complete -c " << program << " -f\n";
+			for (const auto& command : commands_) {
+				out << "complete -c " << program << " -n __fish_use_subcommand -a " << detail::shell_quote(command->name)
+					<< " -d " << detail::shell_quote(detail::shell_escape(command->help, "")) << "\n";
+			}
+			for (const auto& [command, parser] : parsers) {
+				std::string condition;
+				if (!command.empty()) condition = " -n " + detail::shell_quote("__fish_seen_subcommand_from " + detail::shell_quote(command));
+				else if (!commands_.empty()) condition = " -n " + detail::shell_quote("not __fish_seen_subcommand_from " + commands);
+				out << "complete -c " << program << condition << " -s h -l help -d 'Show help'\n";
+
+				for (const auto& arg : parser->args_) {
+					out << "complete -c " << program << condition << " -l " << detail::shell_quote(arg.name());
+					for (std::string_view alias : arg.aliases()) out << (alias.size() == 1 ? " -s " : " -o ") << detail::shell_quote(alias);
+					if (!arg.help().empty()) out << " -d " << detail::shell_quote(detail::shell_escape(arg.help(), ""));
+					if (!arg.is_flag() && completes_files(arg)) out << " -r -F";
+					else if (!arg.is_flag() && arg.choices().empty()) out << " -x";
+					else if (!arg.is_flag()) out << " -x -a " << detail::shell_quote(Argument::join_strings(arg.choices(), " "));
+					out << "\n";
+				}
+			}
+		}
+
+		/**
+		 * @brief Parses row `row` of the lines handed to parse_batch(), with `scratch` for its results.
+		 */
+		using BatchLine = ParseResult (*)(const ArgumentParser& parser, const void* lines, size_t row, std::pmr::memory_resource* scratch);
+
+		/**
+		 * @brief The body of parse_batch(), which only adapts the range of lines to `line`.
+		 */
+		BatchResult parse_lines(const void* lines, size_t rows, BatchLine line, unsigned threads, std::pmr::memory_resource* resource) const;
+
+		/**
+		 * @brief Copies one line's values into row `row` of a batch, their contents into `arena`.
+		 */
+		void scatter(const ParsedArgs& args, size_t row, std::pmr::memory_resource& arena, BatchResult& batch) const
+		{
+			auto copy = [&](const void* data, size_t bytes, size_t align) -> const void* {
+				if (bytes == 0) return nullptr;
+				void* to = arena.allocate(bytes, align);
+				std::memcpy(to, data, bytes);
+				return to;
+			};
+			auto copy_text = [&](std::string_view text) {
+				return std::string_view(static_cast<const char*>(copy(text.data(), text.size(), 1)), text.size());
+			};
+
+			for (size_t i = 0; i < args.size_; ++i) {
+				detail::ValueView value = args.values_[i];
+				if (auto text = std::get_if<std::string_view>(&value)) {
+					*text = copy_text(*text);
+				}
+				else if (auto list = std::get_if<detail::ListView>(&value)) {
+					list->data = copy(list->data, ParsedArgs::element_size(list->type) * list->size, alignof(std::string_view));
+					if (list->type == detail::ElementType::STRING) {
+						auto* items = static_cast<std::string_view*>(const_cast<void*>(list->data));
+						for (uint32_t j = 0; j < list->size; ++j) items[j] = copy_text(items[j]);
+					}
+				}
+				batch.store(i, row, value);
+			}
+			if (!batch.commands_.empty()) batch.commands_[row] = copy_text(args.subcommand());
+		}
+
+		/**
+		 * @brief Adds the environment and configuration values this parser, and the
+		 *        subcommand the rest of `tokens` selects, could read.
+		 */
+		void hash_env(detail::Hasher& hash, detail::TokenStream& tokens, bool abbrev) const
+		{
+			for (size_t i = 0; i < args_.size(); ++i) {
+				const Argument& arg = args_[i];
+				const Slot* slot = hot_ ? &hot_->slots[i] : nullptr;
+				std::optional<std::string_view> value;
+				if (arg.env_var_ && (!slot || slot->has(Slot::CHECK_ENV))) value = arg.env_value(env_.get());
+				if (!value && slot && slot->has(Slot::FOUND)) value = slot->text;
+				if (!arg.env_var_ && !slot) continue;
+				hash.add(static_cast<uint64_t>(value.has_value()));
+				if (value) hash.add(*value);
+			}
+			if (commands_.empty()) return;
+			auto word = command_word(tokens, abbrev);
+			if (const Subcommand* command = word ? find_command(*word) : nullptr) {
+				const ArgumentParser& child = build(*command);
+				child.hash_env(hash, tokens, abbrev || child.allow_abbrev_);
+			}
+		}
+
+		/**
+		 * @brief Resolves an abbreviated long option.
+		 * @param token The option, which matched no name exactly.
+		 * @param ambiguous Set if the prefix matches more than one argument.
+		 * @return The matched argument, or std::nullopt if none or several match.
+		 */
+		std::optional<size_t> match_prefix(const detail::Token& token, bool& ambiguous) const
+		{
+			if (token.name.empty()) return std::nullopt;
+			const auto matches = lookup_->with_prefix(token.name);
+			if (matches.empty()) return std::nullopt;
+
+			const size_t first = matches.front().index;
+			const bool unique = std::all_of(matches.begin(), matches.end(),
+				[&](const detail::NameIndex::Entry& entry) { return entry.index == first; });
+			if (unique) return first;
+			ambiguous = true;
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief The arguments an ambiguous abbreviation could stand for, as "--a, --b".
+		 */
+		std::string candidates(std::string_view text) const
+		{
+			std::vector<std::string> names;
+			for (const auto& entry : lookup_->with_prefix(detail::classify(text).name)) {
+				std::string name = "--" + std::string(args_[entry.index].name());
+				if (std::find(names.begin(), names.end(), name) == names.end()) names.push_back(std::move(name));
+			}
+			return Argument::join_strings(names, ", ");
+		}
+
+		/**
+		 * @brief Parses the tokens left in `tokens`, handing them to a subcommand once one is named.
+		 * @param inherited Settings of the parser that selected this one as a subcommand.
+		 */
+		ParseResult run(detail::TokenStream& tokens, std::pmr::memory_resource* resource, const Inherited* inherited = nullptr) const
+		{
+			using Code = ParseError::Code;
+			constexpr size_t npos = ParseError::npos;
+			if (!lookup_) {
+				return ParseResult::failure(ParseError(Code::NOT_COMPILED, npos, npos, {}, this));
+			}
+#if ARGPARSE_INSTRUMENTATION
+			detail::ActiveCounters active(counters_.get());
+#endif
+			const Inherited settings{ allow_abbrev_ || (inherited && inherited->allow_abbrev), lazy_ || (inherited && inherited->lazy) };
+
+			// Scratch state lives on the stack and only spills into `resource` for large schemas.
+			std::array<std::byte, 4096> scratch_buffer;
+			std::pmr::monotonic_buffer_resource scratch(scratch_buffer.data(), scratch_buffer.size(), resource);
+
+			// Values stay as views into the token source until they are stored below,
+			// packed with their token position into the size of one string_view.
+			struct Provided
+			{
+				const char* data = nullptr;
+				uint32_t size = 0;
+				uint32_t position = 0;
+
+				Provided() = default;
+				Provided(std::string_view text, size_t at = 0)
+					: data(text.data()), size(static_cast<uint32_t>(text.size())), position(static_cast<uint32_t>(at))
+				{
+				}
+
+				std::string_view text() const
+				{
+					return { data, size };
+				}
+			};
+			std::pmr::vector<Provided> provided(args_.size(), &scratch);
+			const std::vector<Slot>& slots = hot_->slots;
+			std::optional<ParseError> error;
+			auto fail = [&](Code code, size_t arg, size_t token, std::string_view text) {
+				return ParseResult::failure(ParseError(code, arg, token, text, this));
+			};
+
+			// Values of list arguments, tagged with the occurrence they came from.
+			struct ListToken
+			{
+				size_t arg;
+				uint32_t occurrence;
+				uint32_t position;
+				std::string_view text;
+			};
+			std::pmr::vector<ListToken> list_tokens(&scratch);
+			std::pmr::vector<uint32_t> occurrences(&scratch);
+			const Subcommand* command = nullptr;
+
+			{
+				ARGPARSE_PHASE(TOKENIZE);
+				while (!tokens.done()) {
+					const detail::Token token = tokens.next();
+
+					if (token.is_help()) return ParseResult::help(this);
+
+					// After the first error only keep scanning for --help, which takes precedence.
+					if (error) continue;
+
+					const size_t at = tokens.position();
+					if (token.kind == detail::Token::Kind::VALUE) {
+						// A word in option position names the subcommand, which parses the rest.
+						if (commands_.empty()) continue;
+						command = find_command(token.text);
+						if (command) break;
+						error = ParseError(Code::UNKNOWN_SUBCOMMAND, npos, at, token.text, this);
+						continue;
+					}
+
+					auto pos = lookup_->find(token.name);
+					if (!pos && settings.allow_abbrev && token.kind == detail::Token::Kind::LONG) {
+						bool ambiguous = false;
+						pos = match_prefix(token, ambiguous);
+						if (ambiguous) {
+							error = ParseError(Code::AMBIGUOUS_ARGUMENT, npos, at, token.text, this);
+							continue;
+						}
+					}
+					if (!pos) {
+						error = ParseError(Code::UNRECOGNIZED_ARGUMENT, npos, at, token.text, this);
+						continue;
+					}
+
+					const Slot& slot = slots[*pos];
+					if (slot.has(Slot::FLAG)) {
+						provided[*pos] = detail::flag_marker;
+					}
+					else if (slot.has(Slot::LIST)) {
+						if (occurrences.empty()) occurrences.resize(args_.size());
+						const uint32_t occurrence = ++occurrences[*pos];
+						size_t taken = 0;
+						for (; taken < slot.nargs_max && tokens.next_is_value(slot.has(Slot::NEGATIVE)); ++taken) {
+							const std::string_view text = tokens.next().text;
+							list_tokens.push_back({ *pos, occurrence, static_cast<uint32_t>(tokens.position()), text });
+						}
+						provided[*pos] = detail::flag_marker;
+						if (taken < slot.nargs_min) {
+							error = ParseError(Code::TOO_FEW_VALUES, *pos, at, token.text, this);
+						}
+					}
+					else if (tokens.next_is_value(slot.has(Slot::NEGATIVE))) {
+						const std::string_view text = tokens.next().text;
+						provided[*pos] = Provided(text, tokens.position());
+					}
+					else {
+						error = ParseError(Code::MISSING_VALUE, *pos, at, token.text, this);
+					}
+				}
+			}
+
+			std::optional<ParseResult> nested;
+			if (command) {
+				try {
+					nested = build(*command).run(tokens, resource, &settings);
+				}
+				catch (const ArgumentError& e) {
+					return ParseResult::failure(ParseError(e, std::current_exception(), npos, this));
+				}
+				if (!*nested) return std::move(*nested);
+			}
+
+			if (tokens.error()) {
+				ParseError file_error = *tokens.error();
+				return fail(file_error.code(), npos, file_error.token_position(), file_error.text());
+			}
+			if (error) return ParseResult::failure(std::move(*error));
+
+			// Group list values by argument with a counting sort, keeping only the
+			// last occurrence unless the argument appends.
+			auto keep = [&](const ListToken& token) {
+				return slots[token.arg].has(Slot::APPEND) || token.occurrence == occurrences[token.arg];
+			};
+			std::pmr::vector<size_t> list_begin(&scratch);
+			std::pmr::vector<std::string_view> grouped(&scratch);
+			if (!list_tokens.empty()) {
+				list_begin.assign(args_.size() + 1, 0);
+				for (const auto& token : list_tokens) {
+					if (keep(token)) ++list_begin[token.arg + 1];
+				}
+				for (size_t i = 0; i < args_.size(); ++i) list_begin[i + 1] += list_begin[i];
+				grouped.resize(list_begin.back());
+				std::pmr::vector<size_t> fill(list_begin.begin(), list_begin.end() - 1, &scratch);
+				for (const auto& token : list_tokens) {
+					if (keep(token)) grouped[fill[token.arg]++] = token.text;
+				}
+			}
+
+			struct ListPlan
+			{
+				std::span<const std::string_view> tokens;
+				std::string_view env;
+				size_t count = 0;
+			};
+			std::pmr::vector<ListPlan> lists(&scratch);
+
+			std::pmr::vector<detail::ValueView> values(&scratch);
+			values.reserve(args_.size());
+			// Values a lazy parse stores as text, converted when they are read.
+			std::pmr::vector<uint32_t> deferred(&scratch);
+			size_t string_bytes = 0;
+			size_t list_bytes = 0;
+
+			try {
+				for (size_t i = 0; i < args_.size(); ++i) {
+					const Slot& slot = slots[i];
+					detail::ValueView value = slot.value;
+
+					if (slot.has(Slot::LIST)) {
+						if (lists.empty()) lists.resize(args_.size());
+						ListPlan& plan = lists[i];
+						if (provided[i].data) {
+							if (!list_begin.empty()) {
+								plan.tokens = std::span<const std::string_view>(grouped).subspan(list_begin[i], list_begin[i + 1] - list_begin[i]);
+							}
+						}
+						else if (auto env_val = slot.has(Slot::CHECK_ENV) ? args_[i].env_value() : std::nullopt) {
+							plan.env = *env_val;
+						}
+						else if (slot.has(Slot::FOUND)) {
+							plan.env = slot.text;
+						}
+						else if (slot.has(Slot::REQUIRED)) {
+							return fail(Code::MISSING_REQUIRED, i, npos, {});
+						}
+						if (plan.env.data()) plan.tokens = std::span<const std::string_view>(&plan.env, 1);
+						if (!plan.tokens.empty()) {
+							const Argument& arg = args_[i];
+							plan.count = arg.count_elements(plan.tokens, string_bytes);
+							list_bytes += ParsedArgs::list_bytes(arg.element_type(), plan.count);
+						}
+					}
+					else if (slot.has(Slot::FLAG)) {
+						if (provided[i].data) value = true;
+					}
+					else if (provided[i].data && settings.lazy) {
+						value = provided[i].text();
+						deferred.push_back(static_cast<uint32_t>(i));
+					}
+					else if (provided[i].data) {
+						const Code code = args_[i].try_convert(provided[i].text(), value);
+						if (code != Code::NONE) return fail(code, i, provided[i].position, provided[i].text());
+					}
+					else if (auto env_val = slot.has(Slot::CHECK_ENV) ? args_[i].env_value() : std::nullopt) {
+						if (settings.lazy) {
+							value = *env_val;
+							deferred.push_back(static_cast<uint32_t>(i));
+						}
+						else {
+							const Code code = args_[i].try_convert(*env_val, value);
+							if (code != Code::NONE) return fail(code, i, npos, *env_val);
+						}
+					}
+					else if (slot.has(Slot::FOUND)) {
+						if (slot.code != Code::NONE) return fail(slot.code, i, npos, slot.text);
+					}
+					else if (slot.has(Slot::REQUIRED)) {
+						return fail(Code::MISSING_REQUIRED, i, npos, {});
+					}
+
+					if (auto text = std::get_if<std::string_view>(&value)) string_bytes += text->size();
+					values.push_back(value);
+				}
+
+				ParsedArgs result(lookup_, values.size(), list_bytes, string_bytes, resource);
+				for (size_t i = 0; i < values.size(); ++i) {
+					if (std::holds_alternative<detail::ListView>(values[i]) && !lists[i].tokens.empty()) {
+						std::string_view culprit;
+						const Code code = result.store_list(i, args_[i], lists[i].tokens, lists[i].count, culprit);
+						if (code != Code::NONE) {
+							// Environment values have no token; command-line ones are found by address.
+							size_t at = npos;
+							for (const auto& token : list_tokens) {
+								if (token.arg == i && culprit.data() >= token.text.data() &&
+									culprit.data() <= token.text.data() + token.text.size()) {
+									at = token.position;
+								}
+							}
+							return fail(code, i, at, culprit);
+						}
+					}
+					else {
+						result.store(i, values[i]);
+					}
+				}
+				for (uint32_t i : deferred) result.defer(i, this);
+				if (nested) result.set_command(command->name, std::move(nested->args_));
+				return ParseResult::success(std::move(result));
+			}
+			catch (const ArgumentError& e) {
+				// Custom validators may still throw their own errors.
+				return ParseResult::failure(ParseError(e, std::current_exception(), npos, this));
+			}
+		}
+
+		friend class ParseError;
+	};
+
+	// Not inline, so the explicit instantiations in ARGPARSE_INSTANTIATIONS take effect.
+	template<typename T>
+	Argument& Argument::default_value(T val)
+	{
+		if constexpr (std::is_enum_v<T>) default_value_ = static_cast<int>(val);
+		else if constexpr (detail::is_duration_v<T>) {
+			default_value_ = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(val).count());
+		}
+		else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, int>) {
+			if constexpr (std::is_signed_v<T>) default_value_ = static_cast<int64_t>(val);
+			else default_value_ = static_cast<uint64_t>(val);
+		}
+		else if constexpr (std::is_floating_point_v<T> && !std::is_same_v<T, float>) default_value_ = static_cast<double>(val);
+		else default_value_ = val;
+		coerce_default();
+		return *this;
+	}
+
+	template<typename T>
+	T ParsedArgs::get(std::string_view name) const
+	{
+		const detail::ValueView& value = slot(name);
+		if constexpr (std::is_same_v<T, std::string>) return std::string(std::get<std::string_view>(value));
+		else if constexpr (std::is_enum_v<T>) return static_cast<T>(std::get<int>(value));
+		else if constexpr (detail::is_duration_v<T>) return detail::from_stored<T>(std::get<int64_t>(value));
+		else return std::get<T>(value);
+	}
+
+	template<typename T>
+	std::span<const T> ParsedArgs::get_list(std::string_view name) const
+	{
+		const auto& list = std::get<detail::ListView>(slot(name));
+		if (list.type != detail::element_type_of<T>()) throw std::bad_variant_access();
+		return { static_cast<const T*>(list.data), list.size };
+	}
+
+#if !ARGPARSE_COMPILED || defined(ARGPARSE_BUILDING_LIBRARY)
+	// The entry points of ArgumentParser, lazy conversion and error messages. With the
+	// argparse::argparse library they are compiled once in src/arg_parser.cpp, and other
+	// translation units only see their declarations, so they no longer generate the
+	// parsing, help and completion code.
+	ARGPARSE_INLINE std::optional<ParseError> ParsedArgs::try_convert(size_t index) const
+	{
+		const std::string_view text = std::get<std::string_view>(values_[index]);
+		detail::ValueView value;
+		ParseError::Code code;
+		try {
+			code = parser_->arguments()[index].try_convert(text, value);
+		}
+		catch (const ArgumentError& e) {
+			// Custom validators may still throw their own errors.
+			return ParseError(e, std::current_exception(), index, parser_);
+		}
+		if (code != ParseError::Code::NONE) return ParseError(code, index, ParseError::npos, text, parser_);
+		values_[index] = value;
+		pending_[index / 64] &= ~(uint64_t(1) << (index % 64));
+		return std::nullopt;
+	}
+
+	ARGPARSE_INLINE std::string ParseError::message() const
+	{
+		const std::string shown(text());
+		const Argument* arg = parser_ && argument_ < parser_->arguments().size() ? &parser_->arguments()[argument_] : nullptr;
+		switch (code_)
+		{
+			case Code::NONE: return {};
+			case Code::HELP_REQUESTED: return "Help requested";
+			case Code::NOT_COMPILED: return "Parser is not compiled; call compile() first";
+			case Code::UNRECOGNIZED_ARGUMENT: return "Unrecognized argument: " + shown;
+			case Code::AMBIGUOUS_ARGUMENT:
+				return "Ambiguous argument: " + shown + " could match " + (parser_ ? parser_->candidates(shown) : std::string());
+			case Code::MISSING_VALUE: return "Missing value for " + shown;
+			case Code::TOO_FEW_VALUES:
+				return "Expected at least " + std::to_string(arg ? arg->nargs_min() : 0) + " values for " + shown;
+			case Code::MISSING_REQUIRED: return "Missing required argument: --" + (arg ? std::string(arg->name()) : shown);
+			case Code::UNKNOWN_SUBCOMMAND: return "Unknown subcommand: " + shown;
+			case Code::UNREADABLE_FILE: return "Cannot read argument file: " + shown;
+			case Code::UNREADABLE_STREAM: return "Cannot read arguments from stream";
+			case Code::UNREADABLE_RESPONSE_FILE: return "Cannot read response file: @" + shown;
+			case Code::RESPONSE_FILES_TOO_DEEP: return "Response files nested too deeply: @" + shown;
+			case Code::OTHER:
+				if (thrown_) {
+					try {
+						std::rethrow_exception(thrown_);
+					}
+					catch (const std::exception& e) {
+						return e.what();
+					}
+				}
+				return shown;
+			default: return arg ? arg->describe(code_, shown) : Argument::describe_value(code_, shown);
+		}
+	}
+
+	ARGPARSE_INLINE void ArgumentParser::build_slots()
+	{
+		auto hot = std::make_shared<HotSchema>();
+		hot->env = env_;
+		hot->config = config_;
+		hot->slots.resize(args_.size());
+
+		// Reserved up front so the views into it never dangle.
+		size_t default_bytes = 0;
+		for (const auto& arg : args_) {
+			if (auto text = std::get_if<std::string>(&arg.default_value())) default_bytes += text->size();
+		}
+		hot->defaults.reserve(default_bytes);
+
+		auto saturate = [](size_t n) { return static_cast<uint32_t>(std::min<size_t>(n, std::numeric_limits<uint32_t>::max())); };
+
+		// Like argparse, "-5" is only a value when no option could be spelled that way.
+		bool negative_values = true;
+		for (const auto& arg : args_) {
+			if (detail::starts_number(arg.name())) negative_values = false;
+			for (std::string_view alias : arg.aliases()) {
+				if (detail::starts_number(alias)) negative_values = false;
+			}
+		}
+
+		std::string key = config_prefix_;
+		for (size_t i = 0; i < args_.size(); ++i) {
+			const Argument& arg = args_[i];
+			Slot& slot = hot->slots[i];
+			slot.nargs_min = saturate(arg.nargs_min());
+			slot.nargs_max = saturate(arg.nargs_max());
+			slot.flags = (arg.is_flag() ? Slot::FLAG : 0) | (arg.is_list() ? Slot::LIST : 0) |
+				(arg.is_append() ? Slot::APPEND : 0) | (arg.is_required() ? Slot::REQUIRED : 0);
+			if (negative_values && arg.type() != Argument::ArgType::STRING && arg.type() != Argument::ArgType::BOOL) {
+				slot.flags |= Slot::NEGATIVE;
+			}
+			if (arg.is_list()) {
+				slot.value = detail::ListView{ nullptr, 0, arg.element_type() };
+			}
+			else if (auto text = std::get_if<std::string>(&arg.default_value())) {
+				const size_t offset = hot->defaults.size();
+				hot->defaults += *text;
+				slot.value = std::string_view(hot->defaults).substr(offset);
+			}
+			else {
+				slot.value = detail::to_view(arg.default_value());
+			}
+
+			std::optional<std::string_view> text;
+			if (arg.env_var_ && !arg.is_flag()) {
+				if (env_) text = env_->get(*arg.env_var_);
+				else slot.flags |= Slot::CHECK_ENV;
+			}
+			if (!text && config_) {
+				key.resize(config_prefix_.size());
+				text = config_->get(key += arg.name());
+				for (auto alias = arg.aliases().begin(); !text && alias != arg.aliases().end(); ++alias) {
+					key.resize(config_prefix_.size());
+					text = config_->get(key += *alias);
+				}
+			}
+			if (!text) continue;
+
+			slot.flags |= Slot::FOUND;
+			slot.text = *text;
+			if (arg.is_list()) continue;
+			if (arg.is_flag()) {
+				slot.value = (*text == "true" || *text == "1");
+			}
+			else {
+				detail::ValueView value;
+				slot.code = arg.try_convert(*text, value);
+				if (slot.code == ParseError::Code::NONE) slot.value = value;
+			}
+		}
+		hot_ = std::move(hot);
+	}
+
+	ARGPARSE_INLINE ArgumentParser& ArgumentParser::compile()
+	{
+		ARGPARSE_PHASE_FOR(counters_.get(), BUILD_LOOKUP);
+		for (auto& arg : args_) arg.freeze();
+		lookup_ = detail::index_arguments(args_, names_);
+		help_cache_ = std::make_shared<HelpCache>();
+		build_slots();
+
+		detail::Hasher hash;
+		hash.add((uint64_t(allow_abbrev_) << 1) | uint64_t(response_files_));
+		hash.add(args_.size());
+		for (const auto& arg : args_) arg.hash_schema(hash);
+		hash.add(commands_.size());
+		for (const auto& command : commands_) hash.add(command->name);
+		schema_hash_ = hash.value;
+		return *this;
+	}
+
+	ARGPARSE_INLINE std::string ArgumentParser::help() const
+	{
+		std::string text;
+		auto append = [&](std::string_view piece) { text.append(piece); };
+		if (!help_cache_) {
+			emit_help(append, HelpLayout::TABS);
+			return text;
+		}
+		std::call_once(help_cache_->built, [&] {
+			emit_help(append, HelpLayout::TABS);
+			help_cache_->text = std::move(text);
+			help_cache_->ready.store(true, std::memory_order_release);
+		});
+		return help_cache_->text;
+	}
+
+	ARGPARSE_INLINE void ArgumentParser::write_help(std::ostream& out, HelpLayout layout) const
+	{
+		if (const std::string* cached = layout == HelpLayout::TABS ? cached_help() : nullptr) {
+			out.write(cached->data(), static_cast<std::streamsize>(cached->size()));
+			return;
+		}
+		auto write = [&](std::string_view piece) { out.write(piece.data(), static_cast<std::streamsize>(piece.size())); };
+		emit_help(write, layout);
+	}
+
+	ARGPARSE_INLINE void ArgumentParser::write_help(std::FILE* out, HelpLayout layout) const
+	{
+		if (const std::string* cached = layout == HelpLayout::TABS ? cached_help() : nullptr) {
+			std::fwrite(cached->data(), 1, cached->size(), out);
+			return;
+		}
+		auto write = [&](std::string_view piece) { std::fwrite(piece.data(), 1, piece.size(), out); };
+		emit_help(write, layout);
+	}
+
+	ARGPARSE_INLINE ParsedArgs ArgumentParser::parse_args(int argc, char** argv)
+	{
+		if (!lookup_) compile();
+
+		if (completion_ && argc > 1 && argv[1] == std::string_view("--complete")) {
+			std::vector<std::string_view> words(argv + 2, argv + argc);
+			if (words.empty()) words.emplace_back();
+			for (const auto& candidate : complete(words)) std::cout << candidate << '\n';
+			std::exit(0);
+		}
+		if (completion_ && argc == 3 && argv[1] == std::string_view("--completion-script")) {
+			const std::string_view name = argv[2];
+			if (name != "bash" && name != "zsh" && name != "fish") {
+				throw ArgumentError("Unknown shell: " + std::string(name) + " (expected bash, zsh or fish)");
+			}
+			write_completion_script(std::cout, name == "bash" ? Shell::BASH : name == "zsh" ? Shell::ZSH : Shell::FISH);
+			std::exit(0);
+		}
+
+		ParseResult result = parse(argc, argv);
+		if (result.help_requested()) {
+			result.help_parser()->write_help(std::cout);
+			std::exit(0);
+		}
+		if (!result) throw ArgumentError(result.error());
+		return std::move(result).args();
+	}
+
+	ARGPARSE_INLINE expected<ParsedArgs, ParseError> ArgumentParser::try_parse_args(int argc, const char* const* argv)
+	{
+		if (!lookup_) {
+			try {
+				compile();
+			}
+			catch (const ArgumentError& e) {
+				return unexpected<ParseError>(ParseError(e, std::current_exception(), ParseError::npos, this));
+			}
+		}
+
+		ParseResult result = parse(argc, argv);
+		if (result.help_requested()) {
+			return unexpected<ParseError>(ParseError(ParseError::Code::HELP_REQUESTED, ParseError::npos, ParseError::npos, {}, result.help_parser()));
+		}
+		if (!result) return unexpected<ParseError>(std::move(result.error_));
+		return std::move(result).args();
+	}
+
+	ARGPARSE_INLINE ParseResult ArgumentParser::parse(int argc, const char* const* argv, std::pmr::memory_resource* resource) const
+	{
+		if (auto_help_ && argc == 1) return ParseResult::help(this);
+
+		detail::TokenStream tokens(response_files_);
+		if (argc > 1) tokens.set_argv(static_cast<size_t>(argc - 1), argv + 1);
+		return run(tokens, resource);
+	}
+
+	ARGPARSE_INLINE ParseResult ArgumentParser::parse_tokens(std::span<const std::string_view> tokens, std::pmr::memory_resource* resource) const
+	{
+		detail::TokenStream stream(response_files_);
+		stream.set_views(tokens.size(), tokens.data());
+		return run(stream, resource);
+	}
+
+	ARGPARSE_INLINE ParseResult ArgumentParser::parse_file(const std::string& path, std::pmr::memory_resource* resource) const
+	{
+		auto file = detail::MappedFile::open(path);
+		if (!file) return ParseResult::failure(ParseError(ParseError::Code::UNREADABLE_FILE, ParseError::npos, ParseError::npos, path, this));
+
+		detail::TokenStream tokens(response_files_);
+		tokens.set_file(std::move(*file));
+		return run(tokens, resource);
+	}
+
+	ARGPARSE_INLINE ParseResult ArgumentParser::parse_stream(std::istream& in, std::pmr::memory_resource* resource) const
+	{
+		auto buffer = detail::MappedFile::read(in);
+		if (!buffer) return ParseResult::failure(ParseError(ParseError::Code::UNREADABLE_STREAM, ParseError::npos, ParseError::npos, {}, this));
+
+		detail::TokenStream tokens(response_files_);
+		tokens.set_file(std::move(*buffer));
+		return run(tokens, resource);
+	}
+
+	ARGPARSE_INLINE BatchResult ArgumentParser::parse_lines(const void* lines, size_t rows, BatchLine line, unsigned threads,
+		std::pmr::memory_resource* resource) const
+	{
+		if (!lookup_) throw ArgumentError(ParseError(ParseError::Code::NOT_COMPILED, ParseError::npos, ParseError::npos, {}, this).message());
+		BatchResult batch(lookup_, rows, resource);
+
+		std::vector<detail::ValueView> empty;
+		std::vector<bool> mixed;
+		for (size_t i = 0; i < args_.size(); ++i) {
+			detail::ValueView cell = hot_->slots[i].value;
+			if (!std::holds_alternative<detail::ListView>(cell)) {
+				std::visit([&](const auto& held) { cell = std::decay_t<decltype(held)>{}; }, cell);
+			}
+			empty.push_back(cell);
+			mixed.push_back(args_[i].type() == Argument::ArgType::AUTO && !args_[i].is_flag() && !args_[i].is_list());
+		}
+		batch.allocate(empty, mixed);
+		if (!commands_.empty()) batch.commands_.resize(rows);
+
+		if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+		const size_t workers = std::max<size_t>(1, std::min<size_t>(threads, rows));
+		std::vector<std::vector<BatchResult::Failure>> failures(workers);
+		for (size_t w = 0; w < workers; ++w) batch.arenas_.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>(resource));
+
+		auto work = [&](size_t w) {
+			const size_t begin = rows * w / workers, end = rows * (w + 1) / workers;
+			std::pmr::memory_resource& arena = *batch.arenas_[w];
+			// Each line's results only live until they are copied into the columns.
+			std::vector<std::byte> buffer(16384);
+			std::pmr::monotonic_buffer_resource scratch(buffer.data(), buffer.size(), resource);
+			for (size_t row = begin; row < end; ++row) {
+				{
+					ParseResult result = line(*this, lines, row, &scratch);
+					if (result) {
+						if (auto error = result.args_.try_validate_all()) result = ParseResult::failure(std::move(*error));
+					}
+					if (result) {
+						scatter(result.args_, row, arena, batch);
+					}
+					else if (result.help_requested()) {
+						failures[w].push_back({ row, ParseError(ParseError::Code::HELP_REQUESTED, ParseError::npos, ParseError::npos, {}, result.help_parser()) });
+					}
+					else {
+						failures[w].push_back({ row, std::move(result.error_) });
+					}
+				}
+				scratch.release();
+			}
+		};
+
+		std::vector<std::thread> pool;
+		std::vector<std::exception_ptr> thrown(workers);
+		for (size_t w = 1; w < workers; ++w) {
+			pool.emplace_back([&, w] {
+				try {
+					work(w);
+				}
+				catch (...) {
+					thrown[w] = std::current_exception();
+				}
+			});
+		}
+		try {
+			work(0);
+		}
+		catch (...) {
+			thrown[0] = std::current_exception();
+		}
+		for (auto& worker : pool) worker.join();
+		for (const auto& error : thrown) {
+			if (error) std::rethrow_exception(error);
+		}
+
+		for (auto& part : failures) {
+			std::move(part.begin(), part.end(), std::back_inserter(batch.errors_));
+		}
+		return batch;
+	}
+
+	ARGPARSE_INLINE std::vector<std::string> ArgumentParser::complete(std::span<const std::string_view> words) const
+	{
+		if (!lookup_) throw ArgumentError(ParseError(ParseError::Code::NOT_COMPILED, ParseError::npos, ParseError::npos, {}, this).message());
+		std::vector<std::string> candidates;
+		if (words.empty()) return candidates;
+
+		const std::string_view partial = words.back();
+		bool command_position = !commands_.empty();
+		if (command_position && words.size() > 1) {
+			detail::TokenStream tokens(false);
+			tokens.set_views(words.size() - 1, words.data());
+			if (auto word = command_word(tokens, allow_abbrev_)) {
+				const Subcommand* command = find_command(*word);
+				if (command) return build(*command).complete(words.subspan(tokens.position() + 1));
+				command_position = false;
+			}
+		}
+		if (words.size() > 1) {
+
+			const std::string_view previous = words[words.size() - 2];
+			auto pos = previous.starts_with('-') ? lookup_->find(detail::strip_dashes(previous)) : std::nullopt;
+			if (pos && !args_[*pos].is_flag()) {
+				const Argument& arg = args_[*pos];
+				if (arg.choice_set_) {
+					for (const auto& entry : arg.choice_set_->index.with_prefix(partial)) candidates.emplace_back(entry.name);
+				}
+				return candidates;
+			}
+		}
+
+		if (partial.starts_with('-')) {
+			for (const auto& entry : lookup_->with_prefix(detail::classify(partial).name)) {
+				std::string spelled = (entry.name == args_[entry.index].name() ? "--" : "-") + std::string(entry.name);
+				if (spelled.starts_with(partial)) candidates.push_back(std::move(spelled));
+			}
+			for (std::string_view help : { "--help", "-h" }) {
+				if (help.starts_with(partial)) candidates.emplace_back(help);
+			}
+		}
+		else if (command_position) {
+			for (const auto& command : commands_) {
+				if (command->name.starts_with(partial)) candidates.push_back(command->name);
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+		return candidates;
+	}
+
+	ARGPARSE_INLINE void ArgumentParser::write_completion_script(std::ostream& out, Shell shell) const
+	{
+		if (!lookup_) throw ArgumentError(ParseError(ParseError::Code::NOT_COMPILED, ParseError::npos, ParseError::npos, {}, this).message());
+		std::vector<std::pair<std::string_view, const ArgumentParser*>> parsers{ { {}, this } };
+		for (const auto& command : commands_) parsers.emplace_back(command->name, &build(*command));
+
+		std::string function = "_";
+		for (char c : prog_name_) function += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+		switch (shell) {
+			case Shell::BASH: write_bash_script(out, parsers, function); break;
+			case Shell::ZSH: write_zsh_script(out, parsers, function); break;
+			case Shell::FISH: write_fish_script(out, parsers); break;
+		}
+	}
+
+	ARGPARSE_INLINE std::optional<uint64_t> ArgumentParser::input_hash(int argc, const char* const* argv) const
+	{
+		detail::Hasher hash;
+		hash.add(static_cast<uint64_t>(argc > 1 ? argc - 1 : 0));
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view token(argv[i]);
+			if (response_files_ && token.size() > 1 && token[0] == '@') return std::nullopt;
+			hash.add(token);
+		}
+		detail::TokenStream tokens(false);
+		if (argc > 1) tokens.set_argv(static_cast<size_t>(argc - 1), argv + 1);
+		hash_env(hash, tokens, allow_abbrev_);
+		return hash.value;
+	}
+
+	ARGPARSE_INLINE std::string ArgumentParser::snapshot(const ParsedArgs& args, uint64_t input_hash) const
+	{
+		if (!lookup_ || args.index_ != lookup_) throw ArgumentError("Results were not produced by this parser");
+		args.validate_all();
+
+		detail::SnapshotHeader header{};
+		std::memcpy(header.magic, detail::snapshot_magic, sizeof(header.magic));
+		header.version = detail::snapshot_version;
+		header.layout = detail::snapshot_layout;
+		header.schema_hash = schema_hash_;
+		header.input_hash = input_hash;
+		header.base = reinterpret_cast<uintptr_t>(args.block_);
+		header.count = args.size_;
+		header.block_size = args.block_size_;
+		if (args.block_) {
+			const char* block = static_cast<const char*>(args.block_);
+			header.lists_offset = ParsedArgs::value_bytes(args.size_);
+			header.strings_offset = static_cast<uint64_t>(args.strings_ - block);
+			header.cursor_offset = static_cast<uint64_t>(args.cursor_ - block);
+		}
+
+		std::string out(sizeof(header), '\0');
+		out.append(static_cast<const char*>(args.block_), args.block_size_);
+		if (args.command_) {
+			const std::string_view name = args.command_->first;
+			const Subcommand* command = find_command(name);
+			if (!command) throw ArgumentError("Unknown subcommand: " + std::string(name));
+			const std::string nested = build(*command).snapshot(args.command_->second, 0);
+			header.command_name_size = name.size();
+			header.command_size = nested.size();
+			out += name;
+			out += nested;
+		}
+		header.checksum = detail::checksum(std::string_view(out).substr(sizeof(header)));
+		std::memcpy(out.data(), &header, sizeof(header));
+		return out;
+	}
+
+	ARGPARSE_INLINE std::optional<ParsedArgs> ArgumentParser::restore(std::span<const char> data, uint64_t input_hash, std::pmr::memory_resource* resource) const
+	{
+		detail::SnapshotHeader header;
+		if (!lookup_ || data.size() < sizeof(header)) return std::nullopt;
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (std::memcmp(header.magic, detail::snapshot_magic, sizeof(header.magic)) != 0 ||
+			header.version != detail::snapshot_version || header.layout != detail::snapshot_layout ||
+			header.schema_hash != schema_hash_ || header.input_hash != input_hash || header.count != args_.size()) {
+			return std::nullopt;
+		}
+
+		const std::string_view body(data.data() + sizeof(header), data.size() - sizeof(header));
+		if (header.block_size > body.size() || header.command_name_size > body.size() - header.block_size ||
+			header.command_size != body.size() - header.block_size - header.command_name_size ||
+			header.lists_offset > header.strings_offset || header.strings_offset > header.cursor_offset ||
+			header.cursor_offset > header.block_size || detail::checksum(body) != header.checksum) {
+			return std::nullopt;
+		}
+
+		ParsedArgs result(lookup_, header.count, header.strings_offset - header.lists_offset,
+			header.block_size - header.strings_offset, resource);
+		if (result.block_size_ != header.block_size) return std::nullopt;
+		if (result.block_) {
+			char* block = static_cast<char*>(result.block_);
+			if (static_cast<uint64_t>(result.lists_ - block) != header.lists_offset) return std::nullopt;
+			if (!result.load_block(body.data(), static_cast<uintptr_t>(header.base))) return std::nullopt;
+			// Every list was filled in when the snapshot was taken.
+			result.lists_ = block + header.strings_offset;
+			result.strings_ = block + header.strings_offset;
+			result.cursor_ = block + header.cursor_offset;
+		}
+
+		if (header.command_name_size) {
+			const std::string_view name = body.substr(header.block_size, header.command_name_size);
+			const Subcommand* command = find_command(name);
+			if (!command) return std::nullopt;
+			auto nested = build(*command).restore(body.substr(header.block_size + header.command_name_size), 0, resource);
+			if (!nested) return std::nullopt;
+			result.set_command(name, std::move(*nested));
+		}
+		return result;
+	}
+
+	ARGPARSE_INLINE ParseResult ArgumentParser::parse_cached(int argc, const char* const* argv, const std::string& cache_path, std::pmr::memory_resource* resource) const
+	{
+		const auto key = input_hash(argc, argv);
+		if (key && lookup_) {
+			if (auto file = detail::MappedFile::open(cache_path)) {
+				auto cached = restore(std::span<const char>(file->begin(), file->end()), *key, resource);
+				if (cached) return ParseResult::success(std::move(*cached));
+			}
+		}
+
+		ParseResult result = parse(argc, argv, resource);
+		if (result && key) {
+			try {
+				detail::write_file(cache_path, snapshot(result.args(), *key));
+			}
+			catch (const ArgumentError&) {
+				// A lazily parsed value was rejected; that is reported when the program reads it.
+			}
+		}
+		return result;
+	}
+#endif
+
+	/**
+	 * @brief String literal usable as a template argument, e.g. `Arg<"count", int>`.
+	 */
+	template<size_t N>
+	struct FixedString
+	{
+		char value[N]{};
+
+		constexpr FixedString(const char (&text)[N])
+		{
+			std::copy_n(text, N, value);
+		}
+
+		constexpr std::string_view view() const
+		{
+			return { value, N - 1 };
+		}
+	};
+
+	/**
+	 * @brief Value type of a StaticParser argument that is a boolean switch.
+	 */
+	struct Flag {};
+
+	namespace detail
+	{
+		/**
+		 * @brief Default behaviour shared by all StaticParser options.
+		 *
+		 * Each option overrides only the hooks it cares about; Arg folds over all of them.
+		 */
+		struct OptionBase
+		{
+			static constexpr bool required = false;
+			static constexpr std::string_view help{};
+
+			static constexpr bool is_alias(std::string_view) { return false; }
+			static constexpr bool numeric_alias = false;
+
+			template<typename A>
+			static constexpr bool alias_matches() { return false; }
+
+			template<typename V>
+			static constexpr void apply_default(V&) {}
+
+			template<typename V>
+			static void check(const V&, std::string_view) {}
+
+			static void describe(std::string&) {}
+			static void describe_aliases(std::string&) {}
+		};
+
+		template<typename T>
+		void append_number(std::string& out, T value)
+		{
+			char buffer[64];
+			auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			if (ec == std::errc()) out.append(buffer, ptr);
+		}
+	}
+
+	/**
+	 * @brief Adds an alias to a StaticParser argument, e.g. `Alias<"c">`.
+	 */
+	template<FixedString A>
+	struct Alias : detail::OptionBase
+	{
+		static constexpr bool is_alias(std::string_view name) { return name == A.view(); }
+		static constexpr bool numeric_alias = detail::starts_number(A.view());
+
+		template<typename Other>
+		static constexpr bool alias_matches() { return Other::matches(A.view()); }
+
+		static void describe_aliases(std::string& out) { out += ", -"; out += A.view(); }
+	};
+
+	/**
+	 * @brief Sets the help text of a StaticParser argument.
+	 */
+	template<FixedString Text>
+	struct Help : detail::OptionBase
+	{
+		static constexpr std::string_view help = Text.view();
+	};
+
+	/**
+	 * @brief Marks a StaticParser argument as required.
+	 */
+	struct Required : detail::OptionBase
+	{
+		static constexpr bool required = true;
+
+		static void describe(std::string& out) { out += " (required)"; }
+	};
+
+	/**
+	 * @brief Sets a numeric or boolean default, e.g. `Default<5>`.
+	 */
+	template<auto V>
+	struct Default : detail::OptionBase
+	{
+		template<typename T>
+		static constexpr void apply_default(T& value) { value = static_cast<T>(V); }
+
+		static void describe(std::string& out)
+		{
+			out += " [default: ";
+			if constexpr (std::is_same_v<decltype(V), bool>) out += V ? "1" : "0";
+			else detail::append_number(out, V);
+			out += "]";
+		}
+	};
+
+	/**
+	 * @brief Sets a string default, e.g. `DefaultText<"RED">`.
+	 */
+	template<FixedString Text>
+	struct DefaultText : detail::OptionBase
+	{
+		template<typename T>
+		static constexpr void apply_default(T& value)
+		{
+			if constexpr (std::is_same_v<T, std::string_view>) value = Text.view();
+		}
+
+		static void describe(std::string& out) { out += " [default: "; out += Text.view(); out += "]"; }
+	};
+
+	/**
+	 * @brief Sets the minimum value of a numeric StaticParser argument.
+	 */
+	template<auto V>
+	struct Min : detail::OptionBase
+	{
+		template<typename T>
+		static void check(const T& value, std::string_view)
+		{
+			if constexpr (std::is_arithmetic_v<T>) {
+				if (detail::less(value, V)) throw ArgumentError("Value must be >= " + std::to_string(V));
+			}
+		}
+	};
+
+	/**
+	 * @brief Sets the maximum value of a numeric StaticParser argument.
+	 */
+	template<auto V>
+	struct Max : detail::OptionBase
+	{
+		template<typename T>
+		static void check(const T& value, std::string_view)
+		{
+			if constexpr (std::is_arithmetic_v<T>) {
+				if (detail::less(V, value)) throw ArgumentError("Value must be <= " + std::to_string(V));
+			}
+		}
+	};
+
+	/**
+	 * @brief Restricts a StaticParser argument to a fixed set of spellings.
+	 */
+	template<FixedString... Options>
+	struct Choices : detail::OptionBase
+	{
+		template<typename T>
+		static void check(const T&, std::string_view text)
+		{
+			if constexpr (!std::is_same_v<T, int>) {
+				if (!((text == Options.view()) || ...)) {
+					std::string options;
+					((options += (options.empty() ? "" : ", "), options += Options.view()), ...);
+					throw ArgumentError("Invalid choice. Options: " + options);
+				}
+			}
+		}
+
+		static void describe(std::string& out)
+		{
+			out += " (choices: ";
+			bool first = true;
+			((out += (first ? "" : ", "), out += Options.view(), first = false), ...);
+			out += ")";
+		}
+	};
+
+	/**
+	 * @brief Runs a compile-time validator on the converted value, e.g.
+	 *        `Validate<[](int v) { return v % 2 == 0; }>`.
+	 *
+	 * The callable is a template argument, so the call is fully inlined.
+	 */
+	template<auto Fn, FixedString Message = "Validation failed.">
+	struct Validate : detail::OptionBase
+	{
+		template<typename T>
+		static void check(const T& value, std::string_view)
+		{
+			if (!Fn(value)) throw ArgumentError(std::string(Message.view()));
+		}
+	};
+
+	/**
+	 * @brief Declares one argument of a StaticParser.
+	 *
+	 * Uses the same rules as Argument: values convert like the matching ArgType,
+	 * choices apply to non-integer values, Min/Max bound numeric values.
+	 *
+	 * @tparam Name The argument name, without dashes.
+	 * @tparam T The value type: int, float, bool, int64_t, uint64_t, double, std::string_view or Flag.
+	 * @tparam Options Any of Alias, Help, Required, Default, DefaultText, Min, Max, Choices, Validate.
+	 */
+	template<FixedString Name, typename T, typename... Options>
+	struct Arg
+	{
+		static_assert(std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, bool> ||
+			std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, double> ||
+			std::is_same_v<T, std::string_view> || std::is_same_v<T, Flag>,
+			"StaticParser values must be int, float, bool, int64_t, uint64_t, double, std::string_view or Flag");
+
+		using value_type = std::conditional_t<std::is_same_v<T, Flag>, bool, T>;
+
+		static constexpr std::string_view name = Name.view();
+		static constexpr bool is_flag = std::is_same_v<T, Flag>;
+		static constexpr bool required = (Options::required || ... || false);
+
+		/**
+		 * @brief Whether "-5" after this option can be its value, unless some option is spelled like a number.
+		 */
+		static constexpr bool numeric_value = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+		static constexpr bool numeric_name = detail::starts_number(name) || (Options::numeric_alias || ... || false);
+
+		static constexpr bool matches(std::string_view candidate)
+		{
+			return candidate == name || (Options::is_alias(candidate) || ...);
+		}
+
+		/**
+		 * @brief Checks whether this argument's name or aliases collide with another argument.
+		 */
+		template<typename Other>
+		static constexpr bool conflicts_with()
+		{
+			return Other::matches(name) || (Options::template alias_matches<Other>() || ...);
+		}
+
+		static constexpr value_type default_value()
+		{
+			value_type value{};
+			(Options::apply_default(value), ...);
+			return value;
+		}
+
+		static value_type convert(std::string_view text)
+		{
+			value_type value{};
+			if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+				if (text.empty()) throw ArgumentError("Missing integer value");
+				auto number = detail::parse_number<T>(text);
+				if (!number) throw ArgumentError("Invalid integer value: " + std::string(text));
+				value = *number;
+			}
+			else if constexpr (std::is_floating_point_v<T>) {
+				auto number = detail::parse_number<T>(text);
+				if (!number) throw ArgumentError("Invalid float value: " + std::string(text));
+				value = *number;
+			}
+			else if constexpr (std::is_same_v<T, bool>) {
+				value = text == "true" || text == "1";
+			}
+			else {
+				value = text;
+			}
+			(Options::check(value, text), ...);
+			return value;
+		}
+
+		static void help_line(std::string& out)
+		{
+			out += "  --";
+			out += name;
+			(Options::describe_aliases(out), ...);
+			out += "\t";
+			((out += Options::help), ...);
+			(Options::describe(out), ...);
+			out += "\n";
+		}
+	};
+
+	/**
+	 * @brief Command-line parser whose schema is fixed at compile time.
+	 *
+	 * Name matching is generated by the compiler and results are stored in a
+	 * plain tuple of typed fields, so parsing performs no heap allocation and
+	 * uses no std::function or std::variant. String values are views into argv.
+	 * Only errors allocate, to build the ArgumentError message.
+	 *
+	 * @code
+	 * using Cli = argparse::StaticParser<
+	 *     argparse::Arg<"count", int, argparse::Required, argparse::Min<1>, argparse::Max<10>>,
+	 *     argparse::Arg<"debug", argparse::Flag, argparse::Alias<"d">>>;
+	 *
+	 * auto args = Cli::parse(argc, argv);
+	 * int count = args.get<"count">();
+	 * @endcode
+	 *
+	 * @tparam Args One Arg per argument.
+	 */
+	template<typename... Args>
+	class StaticParser
+	{
+		static constexpr size_t npos = static_cast<size_t>(-1);
+
+		template<size_t I>
+		using arg_at = std::tuple_element_t<I, std::tuple<Args...>>;
+
+		template<typename A, typename... Rest>
+		static constexpr bool any_conflict()
+		{
+			if constexpr (sizeof...(Rest) == 0) return false;
+			else return ((A::template conflicts_with<Rest>() || Rest::template conflicts_with<A>()) || ...) ||
+				any_conflict<Rest...>();
+		}
+
+		static_assert(sizeof...(Args) == 0 || !any_conflict<Args...>(), "Duplicate argument or alias in StaticParser");
+
+		static constexpr size_t find_index(std::string_view name)
+		{
+			size_t index = npos;
+			size_t i = 0;
+			((Args::matches(name) ? (index = i, true) : (++i, false)) || ...);
+			return index;
+		}
+
+		template<FixedString Name>
+		static constexpr size_t index_of()
+		{
+			constexpr size_t index = find_index(Name.view());
+			static_assert(index != npos, "Unknown StaticParser argument");
+			return index;
+		}
+
+		static constexpr bool is_flag(size_t index)
+		{
+			constexpr bool flags[] = { Args::is_flag..., false };
+			return flags[index];
+		}
+
+		/**
+		 * @brief Whether a negative number after the option at `index` is its value, as for ArgumentParser.
+		 */
+		static constexpr bool takes_negative(size_t index)
+		{
+			constexpr bool numbered = (Args::numeric_name || ... || false);
+			constexpr bool negative[] = { (Args::numeric_value && !numbered)..., false };
+			return negative[index];
+		}
+
+	public:
+		/**
+		 * @brief Typed results of a StaticParser parse.
+		 */
+		class Result
+		{
+			std::tuple<typename Args::value_type...> values_;
+			bool help_ = false;
+
+			friend class StaticParser;
+
+		public:
+			template<FixedString Name>
+			auto& get()
+			{
+				return std::get<index_of<Name>()>(values_);
+			}
+
+			template<FixedString Name>
+			const auto& get() const
+			{
+				return std::get<index_of<Name>()>(values_);
+			}
+
+			/**
+			 * @brief True if --help or -h was given; the values are then not filled in.
+			 */
+			bool help_requested() const
+			{
+				return help_;
+			}
+		};
+
+		/**
+		 * @brief Parse the command-line arguments.
+		 * @param argc Argument count.
+		 * @param argv Argument values; argv[0] is skipped.
+		 * @return The typed results.
+		 * @throws ArgumentError If any validation fails or required argument is missing.
+		 */
+		static Result parse(int argc, const char* const* argv)
+		{
+			Result result;
+			std::array<std::string_view, sizeof...(Args)> provided{};
+			std::string_view unknown, missing;
+
+			detail::Tokenizer tokens(argc, argv);
+			while (!tokens.done()) {
+				const detail::Token token = tokens.next();
+
+				if (token.is_help()) {
+					result.help_ = true;
+					return result;
+				}
+
+				// After the first error only keep scanning for --help, which takes precedence.
+				if (unknown.data() || missing.data() || token.kind == detail::Token::Kind::VALUE) continue;
+
+				const size_t index = find_index(token.name);
+				if (index == npos) {
+					unknown = token.text;
+				}
+				else if (is_flag(index)) {
+					provided[index] = detail::flag_marker;
+				}
+				else if (tokens.next_is_value(takes_negative(index))) {
+					provided[index] = tokens.next().text;
+				}
+				else {
+					missing = token.text;
+				}
+			}
+
+			if (unknown.data()) throw ArgumentError("Unrecognized argument: " + std::string(unknown));
+			if (missing.data()) throw ArgumentError("Missing value for " + std::string(missing));
+
+			fill(result, provided, std::index_sequence_for<Args...>{});
+			return result;
+		}
+
+		/**
+		 * @brief Get a formatted help string showing all arguments and their descriptions.
+		 * @param prog_name The program name shown in the usage line.
+		 * @return The help text.
+		 */
+		static std::string help(std::string_view prog_name)
+		{
+			std::string text = "Usage: ";
+			text += prog_name;
+			text += " [OPTIONS]\n\nOptions:\n";
+			(Args::help_line(text), ...);
+			return text;
+		}
+
+	private:
+		template<size_t... I>
+		static void fill(Result& result, const std::array<std::string_view, sizeof...(Args)>& provided, std::index_sequence<I...>)
+		{
+			(fill_one<I>(std::get<I>(result.values_), provided[I]), ...);
+		}
+
+		template<size_t I, typename V>
+		static void fill_one(V& value, std::string_view raw)
+		{
+			using A = arg_at<I>;
+			if constexpr (A::is_flag) {
+				value = raw.data() ? true : A::default_value();
+			}
+			else if (raw.data()) {
+				value = A::convert(raw);
+			}
+			else if (A::required) {
+				throw ArgumentError("Missing required argument: --" + std::string(A::name));
+			}
+			else {
+				value = A::default_value();
+			}
+		}
+	};
+}
+
+// The instantiations most programs use, for every value type. `PREFIX` is
+// `extern` to declare them and empty to define them, as src/arg_parser.cpp does.
+#define ARGPARSE_INSTANTIATIONS(PREFIX) \
+	PREFIX template int argparse::ParsedArgs::get<int>(std::string_view) const; \
+	PREFIX template float argparse::ParsedArgs::get<float>(std::string_view) const; \
+	PREFIX template std::string argparse::ParsedArgs::get<std::string>(std::string_view) const; \
+	PREFIX template std::string_view argparse::ParsedArgs::get<std::string_view>(std::string_view) const; \
+	PREFIX template bool argparse::ParsedArgs::get<bool>(std::string_view) const; \
+	PREFIX template int64_t argparse::ParsedArgs::get<int64_t>(std::string_view) const; \
+	PREFIX template uint64_t argparse::ParsedArgs::get<uint64_t>(std::string_view) const; \
+	PREFIX template double argparse::ParsedArgs::get<double>(std::string_view) const; \
+	PREFIX template std::chrono::nanoseconds argparse::ParsedArgs::get<std::chrono::nanoseconds>(std::string_view) const; \
+	PREFIX template std::chrono::milliseconds argparse::ParsedArgs::get<std::chrono::milliseconds>(std::string_view) const; \
+	PREFIX template std::chrono::seconds argparse::ParsedArgs::get<std::chrono::seconds>(std::string_view) const; \
+	PREFIX template std::span<const int> argparse::ParsedArgs::get_list<int>(std::string_view) const; \
+	PREFIX template std::span<const float> argparse::ParsedArgs::get_list<float>(std::string_view) const; \
+	PREFIX template std::span<const bool> argparse::ParsedArgs::get_list<bool>(std::string_view) const; \
+	PREFIX template std::span<const int64_t> argparse::ParsedArgs::get_list<int64_t>(std::string_view) const; \
+	PREFIX template std::span<const uint64_t> argparse::ParsedArgs::get_list<uint64_t>(std::string_view) const; \
+	PREFIX template std::span<const double> argparse::ParsedArgs::get_list<double>(std::string_view) const; \
+	PREFIX template std::span<const std::string_view> argparse::ParsedArgs::get_list<std::string_view>(std::string_view) const; \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<int>(int); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<float>(float); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<bool>(bool); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<int64_t>(int64_t); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<uint64_t>(uint64_t); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<double>(double); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<const char*>(const char*); \
+	PREFIX template argparse::Argument& argparse::Argument::default_value<std::string>(std::string);
+
+#if ARGPARSE_COMPILED
+ARGPARSE_INSTANTIATIONS(extern)
+#endif
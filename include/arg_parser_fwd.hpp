@@ -0,0 +1,28 @@
+#pragma once
+
+// Declarations of the argparse types without their definitions, for headers
+// that only pass parsers, arguments and results around by reference or
+// pointer. Include arg_parser.hpp in the files that use them.
+
+namespace argparse
+{
+	class ArgumentError;
+	class ParseError;
+	class EnvSnapshot;
+	class ConfigFile;
+	class Argument;
+	class ParsedArgs;
+	class ParseResult;
+	class BatchResult;
+	class ArgumentParser;
+	struct ParseStats;
+
+	template<typename T>
+	class ArgKey;
+
+	template<typename T>
+	class ListKey;
+
+	enum class HelpLayout;
+	enum class Shell;
+}
@@ -0,0 +1,8 @@
+// The argparse::argparse library: compiles the parser's entry points and the
+// common template instantiations once, so the translation units that link it
+// only declare them.
+
+#define ARGPARSE_BUILDING_LIBRARY
+#include "arg_parser.hpp"
+
+ARGPARSE_INSTANTIATIONS()
@@ -0,0 +1,105 @@
+// Regression checks for behaviour that has broken before. Each check prints
+// what failed; the program exits non-zero if any did.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "arg_parser.hpp"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    if (condition) return;
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++failures;
+}
+
+template<typename F>
+bool throws_argument_error(F&& fn) {
+    try {
+        fn();
+    }
+    catch (const argparse::ArgumentError&) {
+        return true;
+    }
+    return false;
+}
+
+argparse::ParseResult parse(const argparse::ArgumentParser& parser, std::vector<const char*> argv) {
+    argv.insert(argv.begin(), "prog");
+    return parser.parse(static_cast<int>(argv.size()), argv.data());
+}
+
+// An ArgKey on a list argument used to be accepted and then read a ListView as a scalar.
+void arg_key_rejects_lists() {
+    argparse::ArgumentParser parser("prog");
+    check(throws_argument_error([&] { argparse::ArgKey<int> key = parser.add_argument("ids").type_int().delimiter(','); (void)key; }),
+        "ArgKey<int> on a delimited list throws");
+    check(throws_argument_error([&] { argparse::ArgKey<int> key = parser.add_argument("ports").type_int().append(); (void)key; }),
+        "ArgKey<int> on an appended list throws");
+
+    argparse::ArgumentParser lists("prog");
+    argparse::ListKey<int> ids = lists.add_argument("ids").type_int().delimiter(',');
+    lists.compile();
+    auto result = parse(lists, { "--ids", "1,2" });
+    check(result && result.args()[ids].size() == 2, "ListKey<int> reads the same list");
+}
+
+}
+
+// StaticParser took every token starting with '-' for an option, so "--n -5" was missing its value.
+void static_parser_accepts_negative_numbers() {
+    using Cli = argparse::StaticParser<argparse::Arg<"n", int>, argparse::Arg<"ratio", double>, argparse::Arg<"name", std::string_view>>;
+    const char* numbers[] = { "prog", "--n", "-5", "--ratio", "-.25" };
+    auto args = Cli::parse(5, numbers);
+    check(args.get<"n">() == -5 && args.get<"ratio">() == -0.25, "negative numbers are values of numeric options");
+
+    const char* text[] = { "prog", "--name", "-5" };
+    check(throws_argument_error([&] { Cli::parse(3, text); }), "a string option does not take -5");
+
+    // With an option spelled like a number, "-5" names it, as ArgumentParser does.
+    using Numbered = argparse::StaticParser<argparse::Arg<"n", int>, argparse::Arg<"five", argparse::Flag, argparse::Alias<"5">>>;
+    const char* flag[] = { "prog", "--n", "-5" };
+    check(throws_argument_error([&] { Numbered::parse(3, flag); }), "-5 is the option aliased 5");
+}
+
+// parse() always answers --help and -h, so completion offers them even without auto_help().
+void completion_offers_help() {
+    argparse::ArgumentParser parser("prog");
+    parser.auto_help(false);
+    parser.add_argument("verbose").flag();
+    parser.compile();
+    check(parse(parser, { "--help" }).help_requested(), "--help is accepted without auto_help");
+
+    const std::vector<std::string_view> words{ "-" };
+    const std::vector<std::string> expected{ "--help", "--verbose", "-h" };
+    check(parser.complete(words) == expected, "complete() offers --help and -h");
+}
+
+// A ParseError used to copy the rejected text into a std::string, allocating for long tokens.
+void parse_error_text_is_bounded() {
+    argparse::ArgumentParser parser("prog");
+    parser.add_argument("level").type_int()
+        .custom_validation([](int level) { return level < 10; }, "Level must be below 10, " + std::string(400, '!'));
+    parser.compile();
+
+    const std::string token = "--" + std::string(1000, 'x');
+    const auto unknown = parse(parser, { token.c_str() });
+    check(unknown.parse_error().text().size() <= argparse::ParseError::max_text, "text() is cut to max_text");
+    check(unknown.parse_error().text().ends_with("..."), "cut text() ends in ...");
+    check(unknown.error().starts_with("Unrecognized argument: --xxx"), "message() still names the token");
+
+    const auto invalid = parse(parser, { "--level", "12" });
+    check(invalid.error() == "Level must be below 10, " + std::string(400, '!'), "message() keeps a long validator error whole");
+}
+
+int main() {
+    arg_key_rejects_lists();
+    static_parser_accepts_negative_numbers();
+    completion_offers_help();
+    parse_error_text_is_bounded();
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}